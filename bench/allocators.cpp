@@ -0,0 +1,64 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdint>
+
+#include <pat/pat.hpp>
+
+using namespace pat;
+
+/* construct and destroy an 8-queens matrix, without solving it */
+constexpr uint32_t n = 8u;
+
+template<class Solver>
+inline void add_queens_options( Solver& solver )
+{
+  for ( uint32_t i = 1u; i <= n; ++i )
+  {
+    for ( uint32_t j = 1u; j <= n; ++j )
+    {
+      solver.add_option( std::array<uint32_t, 4>{{i, n + j, 2 * n - 1 + i + j, 5 * n - 1 + i - j}} );
+    }
+  }
+}
+
+static void construct_default( benchmark::State& state )
+{
+  for ( auto _ : state )
+  {
+    default_solver solver( 2 * n, 4 * n - 2 );
+    add_queens_options( solver );
+    benchmark::DoNotOptimize( solver );
+  }
+  state.SetItemsProcessed( state.iterations() );
+}
+
+static void construct_arena( benchmark::State& state )
+{
+  arena a;
+  for ( auto _ : state )
+  {
+    a.reset();
+    arena_solver solver( 2 * n, 4 * n - 2, mrv_heuristic(), arena_allocator<uint32_t>( a ) );
+    add_queens_options( solver );
+    benchmark::DoNotOptimize( solver );
+  }
+  state.SetItemsProcessed( state.iterations() );
+}
+
+static void construct_static( benchmark::State& state )
+{
+  for ( auto _ : state )
+  {
+    static_solver<2 * n, 4 * n - 2, 6 * n + n * n * 5> solver;
+    add_queens_options( solver );
+    benchmark::DoNotOptimize( solver );
+  }
+  state.SetItemsProcessed( state.iterations() );
+}
+
+BENCHMARK( construct_default );
+BENCHMARK( construct_arena );
+BENCHMARK( construct_static );
+
+BENCHMARK_MAIN();
@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdint>
+
+#include <pat/pat.hpp>
+
+using namespace pat;
+
+/* head-to-head comparison of the exact cover engines on the test families */
+
+template<class Solver>
+inline void queens( benchmark::State& state )
+{
+  const uint32_t n = 11u;
+  for ( auto _ : state )
+  {
+    Solver solver( 2 * n, 4 * n - 2 );
+    for ( uint32_t i = 1u; i <= n; ++i )
+    {
+      for ( uint32_t j = 1u; j <= n; ++j )
+      {
+        solver.add_option( std::array<uint32_t, 4>{{i, n + j, 2 * n - 1 + i + j, 5 * n - 1 + i - j}} );
+      }
+    }
+    benchmark::DoNotOptimize( solver.solve() );
+  }
+}
+
+template<class Solver>
+inline void langford_pairs( benchmark::State& state )
+{
+  const uint32_t n = 11u;
+  for ( auto _ : state )
+  {
+    Solver solver( 3 * n );
+    for ( auto i = 1u; i <= n; ++i )
+    {
+      for ( auto j = 1u; j <= 2u * n - 1u - i; ++j )
+      {
+        solver.add_option( std::array<uint32_t, 3>{{2 * n + i, j, i + j + 1u}} );
+      }
+    }
+    benchmark::DoNotOptimize( solver.solve() );
+  }
+}
+
+template<class Solver>
+inline void leafy_dags( benchmark::State& state )
+{
+  const uint32_t n = 7u;
+  for ( auto _ : state )
+  {
+    Solver solver( n, ( n * ( n - 1 ) ) / 2 );
+    auto offset = n;
+    for ( auto i = 1u; i <= n; ++i )
+    {
+      solver.add_option( std::array<uint32_t, 1>{{i}} );
+      for ( auto j = 1u; j < i; ++j )
+      {
+        solver.add_option( std::array<uint32_t, 2>{{i, offset + j}} );
+        for ( auto k = j + 1; k < i; ++k )
+        {
+          solver.add_option( std::array<uint32_t, 3>{{i, offset + j, offset + k}} );
+        }
+      }
+      offset += i - 1;
+    }
+    benchmark::DoNotOptimize( solver.solve() );
+  }
+}
+
+BENCHMARK_TEMPLATE( queens, default_solver )->Unit( benchmark::kMillisecond );
+BENCHMARK_TEMPLATE( queens, dancing_cells_solver )->Unit( benchmark::kMillisecond );
+BENCHMARK_TEMPLATE( queens, bitset_solver<> )->Unit( benchmark::kMillisecond );
+
+BENCHMARK_TEMPLATE( langford_pairs, default_solver )->Unit( benchmark::kMillisecond );
+BENCHMARK_TEMPLATE( langford_pairs, dancing_cells_solver )->Unit( benchmark::kMillisecond );
+BENCHMARK_TEMPLATE( langford_pairs, bitset_solver<> )->Unit( benchmark::kMillisecond );
+
+BENCHMARK_TEMPLATE( leafy_dags, default_solver )->Unit( benchmark::kMillisecond );
+BENCHMARK_TEMPLATE( leafy_dags, dancing_cells_solver )->Unit( benchmark::kMillisecond );
+BENCHMARK_TEMPLATE( leafy_dags, bitset_solver<> )->Unit( benchmark::kMillisecond );
+
+BENCHMARK_MAIN();
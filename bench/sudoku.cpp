@@ -0,0 +1,70 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <pat/pat.hpp>
+
+using namespace pat;
+
+/* sudoku puzzles solved by rebuilding the matrix vs. reusing it */
+
+static const std::string puzzle = "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79";
+
+inline void add_sudoku_options( default_solver& solver )
+{
+  for ( auto r = 0u; r < 9u; ++r )
+  {
+    for ( auto c = 0u; c < 9u; ++c )
+    {
+      const auto b = 3u * ( r / 3u ) + c / 3u;
+      for ( auto d = 0u; d < 9u; ++d )
+      {
+        solver.add_option( std::vector<uint32_t>{1u + 9u * r + c, 82u + 9u * r + d, 163u + 9u * c + d, 244u + 9u * b + d} );
+      }
+    }
+  }
+}
+
+inline std::vector<uint32_t> givens()
+{
+  std::vector<uint32_t> options;
+  for ( auto k = 0u; k < 81u; ++k )
+  {
+    if ( puzzle[k] != '.' )
+    {
+      options.push_back( 9u * k + ( puzzle[k] - '1' ) );
+    }
+  }
+  return options;
+}
+
+static void sudoku_rebuild( benchmark::State& state )
+{
+  const auto g = givens();
+  for ( auto _ : state )
+  {
+    default_solver solver( 324u );
+    add_sudoku_options( solver );
+    benchmark::DoNotOptimize( solver.check_uniqueness( g ) );
+  }
+  state.SetItemsProcessed( state.iterations() );
+}
+
+static void sudoku_template( benchmark::State& state )
+{
+  const auto g = givens();
+  default_solver solver( 324u );
+  add_sudoku_options( solver );
+  for ( auto _ : state )
+  {
+    benchmark::DoNotOptimize( solver.check_uniqueness( g ) );
+  }
+  state.SetItemsProcessed( state.iterations() );
+}
+
+BENCHMARK( sudoku_rebuild );
+BENCHMARK( sudoku_template );
+
+BENCHMARK_MAIN();
@@ -0,0 +1,225 @@
+/* pat: C++ dancing links solver
+ * Copyright (C) 2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file allocators.hpp
+  \brief Allocators for solver storage
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+#if defined( __linux__ )
+#include <sys/mman.h>
+#endif
+
+namespace pat
+{
+
+/*! \brief Monotonic memory arena
+
+  Memory is carved from large chunks and only released when the arena is reset
+  or destroyed, which makes allocation a pointer increment and deallocation a
+  no-op.  This is useful to construct many short-lived solvers, e.g., one arena
+  per request in a service.  An arena must outlive all allocators that refer to
+  it.
+*/
+class arena
+{
+public:
+  explicit arena( std::size_t chunk_size = 1u << 16 )
+      : chunk_size( chunk_size ) {}
+
+  arena( const arena& ) = delete;
+  arena& operator=( const arena& ) = delete;
+
+  void* allocate( std::size_t bytes, std::size_t alignment )
+  {
+    while ( current < chunks.size() )
+    {
+      auto& c = chunks[current];
+      const auto offset = ( used + alignment - 1u ) & ~( alignment - 1u );
+      if ( offset + bytes <= c.size )
+      {
+        used = offset + bytes;
+        return c.data.get() + offset;
+      }
+      ++current;
+      used = 0u;
+    }
+
+    const auto size = std::max( chunk_size, bytes + alignment );
+    chunks.push_back( chunk{std::unique_ptr<unsigned char[]>( new unsigned char[size] ), size} );
+    current = chunks.size() - 1u;
+    used = 0u;
+    return allocate( bytes, alignment );
+  }
+
+  /*! \brief Makes all memory available again, but keeps the chunks */
+  void reset()
+  {
+    current = 0u;
+    used = 0u;
+  }
+
+  /*! \brief Total size of all chunks in bytes */
+  std::size_t capacity() const
+  {
+    std::size_t total = 0u;
+    for ( const auto& c : chunks )
+    {
+      total += c.size;
+    }
+    return total;
+  }
+
+private:
+  struct chunk
+  {
+    std::unique_ptr<unsigned char[]> data;
+    std::size_t size;
+  };
+
+  std::size_t chunk_size;
+  std::vector<chunk> chunks;
+  std::size_t current{0u};
+  std::size_t used{0u};
+};
+
+/*! \brief Allocator that draws memory from an ``arena`` */
+template<typename T>
+class arena_allocator
+{
+public:
+  using value_type = T;
+
+  explicit arena_allocator( arena& a ) noexcept
+      : a( &a ) {}
+
+  template<typename U>
+  arena_allocator( const arena_allocator<U>& other ) noexcept
+      : a( other.a ) {}
+
+  T* allocate( std::size_t n )
+  {
+    return static_cast<T*>( a->allocate( n * sizeof( T ), alignof( T ) ) );
+  }
+
+  void deallocate( T*, std::size_t ) noexcept {}
+
+  template<typename U>
+  bool operator==( const arena_allocator<U>& other ) const noexcept
+  {
+    return a == other.a;
+  }
+
+  template<typename U>
+  bool operator!=( const arena_allocator<U>& other ) const noexcept
+  {
+    return a != other.a;
+  }
+
+private:
+  template<typename U>
+  friend class arena_allocator;
+
+  arena* a;
+};
+
+/*! \brief Allocator that backs large buffers by transparent huge pages
+
+  Buffers of at least ``threshold`` bytes are mapped with ``mmap`` and marked
+  with ``MADV_HUGEPAGE``, which reduces TLB misses when walking the nodes of a
+  large matrix.  Smaller buffers, and all buffers on systems other than Linux,
+  are allocated with ``operator new``.
+*/
+template<typename T>
+class huge_page_allocator
+{
+public:
+  using value_type = T;
+
+  static constexpr std::size_t threshold = std::size_t( 1 ) << 21;
+
+  huge_page_allocator() noexcept = default;
+
+  template<typename U>
+  huge_page_allocator( const huge_page_allocator<U>& ) noexcept {}
+
+  T* allocate( std::size_t n )
+  {
+    const auto bytes = n * sizeof( T );
+#if defined( __linux__ )
+    if ( bytes >= threshold )
+    {
+      auto* p = mmap( nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+      if ( p == MAP_FAILED )
+      {
+        throw std::bad_alloc();
+      }
+#if defined( MADV_HUGEPAGE )
+      madvise( p, bytes, MADV_HUGEPAGE );
+#endif
+      return static_cast<T*>( p );
+    }
+#endif
+    return static_cast<T*>( ::operator new( bytes ) );
+  }
+
+  void deallocate( T* p, std::size_t n ) noexcept
+  {
+#if defined( __linux__ )
+    if ( n * sizeof( T ) >= threshold )
+    {
+      munmap( p, n * sizeof( T ) );
+      return;
+    }
+#else
+    (void)n;
+#endif
+    ::operator delete( p );
+  }
+
+  template<typename U>
+  bool operator==( const huge_page_allocator<U>& ) const noexcept
+  {
+    return true;
+  }
+
+  template<typename U>
+  bool operator!=( const huge_page_allocator<U>& ) const noexcept
+  {
+    return false;
+  }
+};
+}
@@ -0,0 +1,206 @@
+/* pat: C++ dancing links solver
+ * Copyright (C) 2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file batch.hpp
+  \brief Solves many independent problems on a thread pool
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "search_limits.hpp"
+#include "solver_types.hpp"
+
+namespace pat
+{
+
+/*! \brief Exact cover problem given by its options */
+struct exact_cover_instance
+{
+  uint32_t primary_items = 0u;
+  uint32_t secondary_items = 0u;
+  std::vector<std::vector<uint32_t>> options;
+};
+
+/*! \brief Result of one problem in a batch */
+struct batch_result
+{
+  /*! \brief Number of solutions found */
+  uint32_t solutions = 0u;
+
+  /*! \brief Reason why the search for this problem returned */
+  solve_status status = solve_status::complete;
+
+  /*! \brief Option indices of the first solution, if there is one */
+  std::vector<uint32_t> first_solution;
+};
+
+/*! \brief Solves batches of independent problems on a thread pool
+
+  The worker threads are started once and each of them owns a solver, which
+  is ``reset`` for every problem, such that its buffers are reused instead of
+  allocated for each problem.  The problems of a batch are claimed one by one
+  by idle workers, and the results are returned in the order of the problems.
+  If ``max_solutions`` is non-zero, the search for each problem stops after
+  that many solutions, e.g., 1 for satisfiability queries.  ``solve`` must not
+  be called concurrently.
+*/
+template<class Solver = default_solver>
+class batch_solver
+{
+public:
+  explicit batch_solver( std::size_t num_threads = std::thread::hardware_concurrency(), uint32_t max_solutions = 0u, const search_limits& limits = search_limits() )
+      : max_solutions( max_solutions ),
+        limits( limits )
+  {
+    num_threads = num_threads == 0u ? 1u : num_threads;
+    for ( auto k = 0u; k < num_threads; ++k )
+    {
+      threads.emplace_back( [this]() { work(); } );
+    }
+  }
+
+  batch_solver( const batch_solver& ) = delete;
+  batch_solver& operator=( const batch_solver& ) = delete;
+
+  ~batch_solver()
+  {
+    {
+      std::lock_guard<std::mutex> lock( mutex );
+      stopping = true;
+    }
+    start.notify_all();
+    for ( auto& t : threads )
+    {
+      t.join();
+    }
+  }
+
+  /*! \brief Solves all problems and returns their results in order */
+  std::vector<batch_result> solve( const std::vector<exact_cover_instance>& instances )
+  {
+    std::vector<batch_result> results( instances.size() );
+
+    std::unique_lock<std::mutex> lock( mutex );
+    current = &instances;
+    current_results = &results;
+    next = 0u;
+    active = threads.size();
+    ++generation;
+    lock.unlock();
+
+    start.notify_all();
+
+    lock.lock();
+    finished.wait( lock, [this]() { return active == 0u; } );
+    current = nullptr;
+    current_results = nullptr;
+
+    return results;
+  }
+
+private:
+  void work()
+  {
+    Solver solver( 0u );
+    solver.set_limits( limits );
+
+    uint64_t seen = 0u;
+    std::unique_lock<std::mutex> lock( mutex );
+    while ( true )
+    {
+      start.wait( lock, [&]() { return stopping || generation != seen; } );
+      if ( stopping )
+      {
+        return;
+      }
+      seen = generation;
+      const auto& instances = *current;
+      auto& results = *current_results;
+      lock.unlock();
+
+      for ( auto k = next++; k < instances.size(); k = next++ )
+      {
+        solve_one( solver, instances[k], results[k] );
+      }
+
+      lock.lock();
+      if ( --active == 0u )
+      {
+        finished.notify_one();
+      }
+    }
+  }
+
+  void solve_one( Solver& solver, const exact_cover_instance& instance, batch_result& result )
+  {
+    solver.reset( instance.primary_items, instance.secondary_items );
+    for ( const auto& option : instance.options )
+    {
+      solver.add_option( option );
+    }
+
+    uint32_t found = 0u;
+    result.solutions = solver.solve( [&]( auto begin, auto end ) {
+      if ( result.first_solution.empty() )
+      {
+        for ( auto it = begin; it != end; ++it )
+        {
+          result.first_solution.push_back( solver.option_index( *it ) );
+        }
+      }
+      return max_solutions == 0u || ++found < max_solutions;
+    } );
+    result.status = solver.status();
+  }
+
+private:
+  uint32_t max_solutions;
+  search_limits limits;
+
+  std::vector<std::thread> threads;
+  std::mutex mutex;
+  std::condition_variable start;
+  std::condition_variable finished;
+  bool stopping = false;
+  uint64_t generation = 0u;
+  std::size_t active = 0u;
+
+  const std::vector<exact_cover_instance>* current = nullptr;
+  std::vector<batch_result>* current_results = nullptr;
+  std::atomic<std::size_t> next{0u};
+};
+
+}
@@ -0,0 +1,219 @@
+/* pat: C++ dancing links solver
+ * Copyright (C) 2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file bitset_solver.hpp
+  \brief Exact cover solver based on bitsets
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "detail/bitset.hpp"
+#include "solution_callbacks.hpp"
+
+namespace pat
+{
+
+/*! \brief Exact cover solver for problems with few items
+
+  Each option is represented as a bitmask over at most ``MaxItems`` items.
+  During search, the solver maintains the set of active primary items and the
+  set of options that are still compatible with the chosen ones.  Choosing an
+  option removes all options that share an item with it by a few vectorized
+  AND-NOT operations, and the MRV item is found by vectorized AND/popcount
+  operations.  For small problems, this avoids the pointer chasing in
+  ``solver``.
+
+  The interface is the same as the one of ``solver``.  Solutions are passed to
+  the callback as option indices, and ``option_index`` is the identity, such
+  that callbacks written for ``solver`` can be reused.
+*/
+template<uint32_t MaxItems = 256u>
+class bitset_solver
+{
+public:
+  static constexpr uint32_t item_words = ( MaxItems + 1u + 63u ) / 64u;
+  using item_mask = std::array<uint64_t, item_words>;
+
+public:
+  explicit bitset_solver( uint32_t primary_items, uint32_t secondary_items = 0u )
+      : primary_items( primary_items ),
+        num_items( primary_items + secondary_items )
+  {
+    assert( num_items <= MaxItems );
+    for ( auto i = 1u; i <= primary_items; ++i )
+    {
+      primary_mask[i >> 6] |= uint64_t( 1 ) << ( i & 63 );
+    }
+  }
+
+  template<class Items>
+  void add_option( const Items& opt_items )
+  {
+    item_mask mask{};
+    for ( auto j : opt_items )
+    {
+      assert( j >= 1 && j <= num_items );
+      mask[j >> 6] |= uint64_t( 1 ) << ( j & 63 );
+    }
+    options.push_back( mask );
+  }
+
+  template<typename Fn = decltype( just_count )&>
+  uint32_t solve( Fn&& fn = just_count )
+  {
+    prepare();
+
+    solutions = 0u;
+    xs.resize( primary_items );
+    alive_stack.assign( ( primary_items + 1u ) * option_words, 0u );
+
+    /* initially all options are alive */
+    for ( auto o = 0u; o < options.size(); ++o )
+    {
+      alive_stack[o >> 6] |= uint64_t( 1 ) << ( o & 63 );
+    }
+
+    search( 0u, primary_mask, fn );
+    return solutions;
+  }
+
+  inline uint32_t option_index( uint32_t i ) const
+  {
+    return i;
+  }
+
+private:
+  void prepare()
+  {
+    option_words = ( static_cast<uint32_t>( options.size() ) + 63u ) / 64u;
+    candidates.assign( ( num_items + 1u ) * option_words, 0u );
+
+    for ( auto o = 0u; o < options.size(); ++o )
+    {
+      for_each_item( options[o], [&]( uint32_t j ) {
+        candidates[j * option_words + ( o >> 6 )] |= uint64_t( 1 ) << ( o & 63 );
+      } );
+    }
+  }
+
+  template<typename Fn>
+  inline void for_each_item( const item_mask& mask, Fn&& fn ) const
+  {
+    for ( auto w = 0u; w < item_words; ++w )
+    {
+      auto word = mask[w];
+      while ( word )
+      {
+        fn( ( w << 6 ) + static_cast<uint32_t>( __builtin_ctzll( word ) ) );
+        word &= word - 1u;
+      }
+    }
+  }
+
+  /* returns false, if search should stop */
+  template<typename Fn>
+  bool search( uint32_t l, const item_mask& active, Fn&& fn )
+  {
+    /* pointer arithmetic, since the buffers are empty without options */
+    const auto* alive = alive_stack.data() + l * option_words;
+
+    /* choose item with fewest remaining options */
+    auto best = 0u;
+    auto min = std::numeric_limits<uint32_t>::max();
+    for_each_item( active, [&]( uint32_t j ) {
+      if ( min <= 1u )
+      {
+        return;
+      }
+      const auto count = detail::and_popcount( candidates.data() + j * option_words, alive, option_words );
+      if ( count < min )
+      {
+        min = count;
+        best = j;
+      }
+    } );
+
+    if ( best == 0u )
+    {
+      ++solutions;
+      return fn( xs.data(), xs.data() + l );
+    }
+
+    auto* child = alive_stack.data() + ( l + 1u ) * option_words;
+    const auto* cands = candidates.data() + best * option_words;
+    for ( auto w = 0u; w < option_words; ++w )
+    {
+      auto word = cands[w] & alive[w];
+      while ( word )
+      {
+        const auto o = ( w << 6 ) + static_cast<uint32_t>( __builtin_ctzll( word ) );
+        word &= word - 1u;
+
+        /* remove all options that share an item with o */
+        const auto& mask = options[o];
+        auto first = true;
+        item_mask next_active;
+        for ( auto k = 0u; k < item_words; ++k )
+        {
+          next_active[k] = active[k] & ~mask[k];
+        }
+        for_each_item( mask, [&]( uint32_t j ) {
+          detail::and_not( child, first ? alive : child, candidates.data() + j * option_words, option_words );
+          first = false;
+        } );
+
+        xs[l] = o;
+        if ( !search( l + 1u, next_active, fn ) )
+        {
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+
+private:
+  uint32_t primary_items;
+  uint32_t num_items;
+  item_mask primary_mask{};
+
+  std::vector<item_mask> options;
+  uint32_t option_words = 0u;
+  std::vector<uint64_t> candidates;
+  std::vector<uint64_t> alive_stack;
+  std::vector<uint32_t> xs;
+  uint32_t solutions = 0u;
+};
+}
@@ -0,0 +1,457 @@
+/* pat: C++ dancing links solver
+ * Copyright (C) 2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file daemon.hpp
+  \brief Long-running solve service with cached matrices
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "batch.hpp"
+#include "detail/bitset.hpp"
+#include "detail/socket.hpp"
+#include "search_limits.hpp"
+#include "solver_types.hpp"
+
+namespace pat
+{
+
+/*! \brief Answer to a query of the daemon
+
+  ``count`` is the number of solutions found, which is 1 for first-solution
+  queries that have a solution, and ``solution`` contains the option indices
+  of the first solution found, if any.
+*/
+struct daemon_answer
+{
+  solve_status status = solve_status::complete;
+  uint64_t count = 0u;
+  std::vector<uint64_t> solution;
+};
+
+/*! \brief Counters of a daemon */
+struct daemon_statistics
+{
+  uint64_t loads = 0u;     /*!< instances that were built */
+  uint64_t hits = 0u;      /*!< instances that were already cached */
+  uint64_t queries = 0u;   /*!< count, first, and forced queries */
+  uint64_t evictions = 0u; /*!< instances removed from the cache */
+};
+
+/*! \cond PRIVATE */
+namespace detail
+{
+/* Message types, see detail/socket.hpp for the framing:
+
+     load      primary and secondary items, then per option its length and
+               items; there are at most as many items as payload words; the
+               reply contains the key of the instance
+     count     key; count all solutions
+     first     key; find one solution
+     forced    key, option indices less than the number of options; count
+               solutions that contain the options
+     shutdown  stops the daemon
+     reply     status, count, and options of the first solution, or the key
+     error     unknown key or malformed request */
+enum class daemon_message : uint64_t
+{
+  load = 1u,
+  count,
+  first,
+  forced,
+  shutdown,
+  reply,
+  error
+};
+}
+/*! \endcond PRIVATE */
+
+/*! \brief Daemon that answers queries on cached instances
+
+  The daemon listens on a Unix-domain socket, see ``daemon_client`` for the
+  client side.  Instances are loaded once and kept as built solvers in a
+  cache with at most ``capacity`` entries, where the least recently used one
+  is evicted, keyed by a hash of the instance.  Each query works on a copy of
+  the cached solver, such that the matrix does not need to be built again and
+  queries on the same instance can run concurrently; each connection is served
+  by its own thread.  ``run`` serves connections until ``stop`` is called or
+  a client sends a shutdown request.  Queries run with the budgets of
+  ``limits``, e.g., a node budget per query, and ``stop`` cancels running
+  queries, whose answers then have status ``cancelled``.
+*/
+template<class Solver = default_solver>
+class solve_daemon
+{
+public:
+  explicit solve_daemon( const std::string& path, std::size_t capacity = 16u, const search_limits& limits = search_limits() )
+      : path( path ),
+        listener( detail::listen_socket( path ) ),
+        capacity( capacity == 0u ? 1u : capacity ),
+        limits( limits )
+  {
+    this->limits.cancel = &stopping;
+  }
+
+  solve_daemon( const solve_daemon& ) = delete;
+  solve_daemon& operator=( const solve_daemon& ) = delete;
+
+  ~solve_daemon()
+  {
+    ::close( listener );
+    ::unlink( path.c_str() );
+  }
+
+  /*! \brief Serves connections until the daemon is stopped */
+  void run()
+  {
+    while ( !stopping.load() )
+    {
+      pollfd fd{listener, POLLIN, 0};
+      if ( ::poll( &fd, 1, 100 ) <= 0 || !( fd.revents & POLLIN ) )
+      {
+        continue;
+      }
+
+      const auto client = ::accept( listener, nullptr, nullptr );
+      if ( client < 0 )
+      {
+        continue;
+      }
+
+      std::lock_guard<std::mutex> lock( mutex );
+      clients.push_back( client );
+      std::thread( [this, client]() { serve( client ); } ).detach();
+    }
+
+    /* wake up threads that wait for requests and wait for them to finish;
+       cancelled queries can still send their answers */
+    std::unique_lock<std::mutex> lock( mutex );
+    for ( auto client : clients )
+    {
+      ::shutdown( client, SHUT_RD );
+    }
+    finished.wait( lock, [this]() { return clients.empty(); } );
+  }
+
+  /*! \brief Makes ``run`` return and cancels running queries */
+  void stop()
+  {
+    stopping = true;
+  }
+
+  daemon_statistics statistics() const
+  {
+    std::lock_guard<std::mutex> lock( mutex );
+    return stats;
+  }
+
+private:
+  struct entry
+  {
+    std::vector<uint64_t> words;
+    std::shared_ptr<const Solver> solver;
+  };
+
+  void serve( int client )
+  {
+    detail::daemon_message type;
+    std::vector<uint64_t> payload;
+    while ( detail::receive_message( client, type, payload ) )
+    {
+      if ( type == detail::daemon_message::shutdown )
+      {
+        stop();
+        break;
+      }
+
+      std::vector<uint64_t> reply;
+      const auto ok = handle( type, payload, reply );
+      if ( !detail::send_message( client, ok ? detail::daemon_message::reply : detail::daemon_message::error, reply ) )
+      {
+        break;
+      }
+    }
+
+    std::lock_guard<std::mutex> lock( mutex );
+    clients.erase( std::find( clients.begin(), clients.end(), client ) );
+    ::close( client );
+    finished.notify_all();
+  }
+
+  bool handle( detail::daemon_message type, const std::vector<uint64_t>& payload, std::vector<uint64_t>& reply )
+  {
+    if ( type == detail::daemon_message::load )
+    {
+      return load( payload, reply );
+    }
+
+    if ( payload.empty() || ( type != detail::daemon_message::count && type != detail::daemon_message::first && type != detail::daemon_message::forced ) )
+    {
+      return false;
+    }
+
+    const auto cached = find( payload[0] );
+    if ( !cached )
+    {
+      return false;
+    }
+
+    /* queries work on a copy of the cached matrix */
+    Solver solver( *cached );
+    solver.set_limits( limits );
+    std::vector<typename Solver::index_type> forced;
+    if ( type == detail::daemon_message::forced )
+    {
+      for ( auto it = payload.begin() + 1; it != payload.end(); ++it )
+      {
+        if ( *it >= solver.num_options() )
+        {
+          return false;
+        }
+        forced.push_back( static_cast<typename Solver::index_type>( *it ) );
+      }
+    }
+
+    const auto first_only = type == detail::daemon_message::first;
+    std::vector<uint64_t> solution;
+    const uint64_t count = solver.solve_given( forced, [&]( auto begin, auto end ) {
+      if ( solution.empty() )
+      {
+        solution.assign( forced.begin(), forced.end() );
+        for ( auto it = begin; it != end; ++it )
+        {
+          solution.push_back( solver.option_index( *it ) );
+        }
+      }
+      return !first_only;
+    } );
+
+    reply = {static_cast<uint64_t>( solver.status() ), count};
+    reply.insert( reply.end(), solution.begin(), solution.end() );
+    return true;
+  }
+
+  bool load( const std::vector<uint64_t>& words, std::vector<uint64_t>& reply )
+  {
+    /* the matrix allocates per item, hence there may not be more items than
+       payload words, which holds if each item is contained in an option */
+    if ( words.size() < 2u || words[0] > words.size() || words[1] > words.size() - words[0] )
+    {
+      return false;
+    }
+
+    const auto key = static_cast<uint64_t>( detail::words_hash()( words ) );
+    reply = {key};
+
+    {
+      std::lock_guard<std::mutex> lock( mutex );
+      const auto it = cache.find( key );
+      if ( it != cache.end() && it->second->words == words )
+      {
+        lru.splice( lru.begin(), lru, it->second );
+        ++stats.hits;
+        return true;
+      }
+    }
+
+    /* build the matrix outside the lock */
+    const auto num_items = words[0] + words[1];
+    std::vector<std::vector<uint64_t>> options;
+    if ( !detail::read_lists( words, 2u, options ) )
+    {
+      return false;
+    }
+    auto solver = std::make_shared<Solver>( static_cast<uint32_t>( words[0] ), static_cast<uint32_t>( words[1] ) );
+    for ( const auto& option : options )
+    {
+      for ( auto j : option )
+      {
+        if ( j < 1u || j > num_items )
+        {
+          return false;
+        }
+      }
+      solver->add_option( option );
+    }
+
+    std::lock_guard<std::mutex> lock( mutex );
+    const auto it = cache.find( key );
+    if ( it != cache.end() )
+    {
+      lru.erase( it->second );
+      cache.erase( it );
+    }
+    lru.push_front( {words, std::move( solver )} );
+    cache[key] = lru.begin();
+    ++stats.loads;
+
+    if ( lru.size() > capacity )
+    {
+      cache.erase( detail::words_hash()( lru.back().words ) );
+      lru.pop_back();
+      ++stats.evictions;
+    }
+    return true;
+  }
+
+  std::shared_ptr<const Solver> find( uint64_t key )
+  {
+    std::lock_guard<std::mutex> lock( mutex );
+    ++stats.queries;
+    const auto it = cache.find( key );
+    if ( it == cache.end() )
+    {
+      return nullptr;
+    }
+    lru.splice( lru.begin(), lru, it->second );
+    return it->second->solver;
+  }
+
+private:
+  std::string path;
+  int listener;
+  std::size_t capacity;
+  std::atomic<bool> stopping{false};
+  search_limits limits;
+
+  mutable std::mutex mutex;
+  std::condition_variable finished;
+  std::vector<int> clients;
+  std::list<entry> lru;
+  std::unordered_map<uint64_t, typename std::list<entry>::iterator> cache;
+  daemon_statistics stats;
+};
+
+/*! \brief Client of ``solve_daemon``
+
+  Queries refer to instances by the key returned by ``load``.  Queries on
+  unknown keys, e.g., of evicted instances, throw ``std::out_of_range``, and
+  socket errors throw ``std::system_error``.
+*/
+class daemon_client
+{
+public:
+  explicit daemon_client( const std::string& path )
+      : fd( detail::connect_socket( path ) )
+  {
+  }
+
+  daemon_client( const daemon_client& ) = delete;
+  daemon_client& operator=( const daemon_client& ) = delete;
+
+  ~daemon_client()
+  {
+    ::close( fd );
+  }
+
+  /*! \brief Loads an instance, unless it is cached, and returns its key */
+  uint64_t load( const exact_cover_instance& instance )
+  {
+    std::vector<uint64_t> words{instance.primary_items, instance.secondary_items};
+    for ( const auto& option : instance.options )
+    {
+      detail::append_list( words, option );
+    }
+    return request( detail::daemon_message::load, words ).front();
+  }
+
+  /*! \brief Counts all solutions */
+  daemon_answer count( uint64_t key )
+  {
+    return answer( request( detail::daemon_message::count, {key} ) );
+  }
+
+  /*! \brief Finds one solution */
+  daemon_answer first( uint64_t key )
+  {
+    return answer( request( detail::daemon_message::first, {key} ) );
+  }
+
+  /*! \brief Counts solutions that contain all given options */
+  daemon_answer forced( uint64_t key, const std::vector<uint64_t>& options )
+  {
+    std::vector<uint64_t> words{key};
+    words.insert( words.end(), options.begin(), options.end() );
+    return answer( request( detail::daemon_message::forced, words ) );
+  }
+
+  /*! \brief Stops the daemon */
+  void shutdown()
+  {
+    detail::send_message( fd, detail::daemon_message::shutdown );
+  }
+
+private:
+  std::vector<uint64_t> request( detail::daemon_message type, const std::vector<uint64_t>& words )
+  {
+    std::vector<uint64_t> reply;
+    if ( !detail::send_message( fd, type, words ) || !detail::receive_message( fd, type, reply ) )
+    {
+      throw std::system_error( ECONNRESET, std::generic_category(), "daemon" );
+    }
+    if ( type != detail::daemon_message::reply || reply.empty() )
+    {
+      throw std::out_of_range( "unknown instance or malformed request" );
+    }
+    return reply;
+  }
+
+  static daemon_answer answer( const std::vector<uint64_t>& reply )
+  {
+    daemon_answer a;
+    a.status = static_cast<solve_status>( reply[0] );
+    a.count = reply.size() > 1u ? reply[1] : 0u;
+    a.solution.assign( reply.begin() + std::min<std::size_t>( 2u, reply.size() ), reply.end() );
+    return a;
+  }
+
+  int fd;
+};
+
+}
@@ -0,0 +1,133 @@
+/* pat: C++ dancing links solver
+ * Copyright (C) 2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file bitset.hpp
+  \brief Vectorized operations on word arrays
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined( __AVX2__ )
+#include <immintrin.h>
+#endif
+
+namespace pat
+{
+namespace detail
+{
+inline uint32_t popcount( uint64_t w )
+{
+  return static_cast<uint32_t>( __builtin_popcountll( w ) );
+}
+
+#if defined( __AVX2__ )
+/* per-byte population count using a nibble lookup table (Mula's algorithm) */
+inline __m256i popcount_bytes( __m256i v )
+{
+  const auto lookup = _mm256_setr_epi8( 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 );
+  const auto low_mask = _mm256_set1_epi8( 0x0f );
+  const auto lo = _mm256_and_si256( v, low_mask );
+  const auto hi = _mm256_and_si256( _mm256_srli_epi16( v, 4 ), low_mask );
+  return _mm256_add_epi8( _mm256_shuffle_epi8( lookup, lo ), _mm256_shuffle_epi8( lookup, hi ) );
+}
+#endif
+
+/*! \brief Returns the number of bits set in ``a & b`` */
+inline uint32_t and_popcount( const uint64_t* a, const uint64_t* b, std::size_t n )
+{
+  uint32_t count = 0u;
+  std::size_t k = 0u;
+#if defined( __AVX2__ )
+  auto acc = _mm256_setzero_si256();
+  for ( ; k + 4u <= n; k += 4u )
+  {
+    const auto va = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( a + k ) );
+    const auto vb = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( b + k ) );
+    acc = _mm256_add_epi64( acc, _mm256_sad_epu8( popcount_bytes( _mm256_and_si256( va, vb ) ), _mm256_setzero_si256() ) );
+  }
+  count += static_cast<uint32_t>( _mm256_extract_epi64( acc, 0 ) + _mm256_extract_epi64( acc, 1 ) +
+                                  _mm256_extract_epi64( acc, 2 ) + _mm256_extract_epi64( acc, 3 ) );
+#endif
+  for ( ; k < n; ++k )
+  {
+    count += popcount( a[k] & b[k] );
+  }
+  return count;
+}
+
+/*! \brief Computes ``dst = a & ~b`` */
+inline void and_not( uint64_t* dst, const uint64_t* a, const uint64_t* b, std::size_t n )
+{
+  std::size_t k = 0u;
+#if defined( __AVX2__ )
+  for ( ; k + 4u <= n; k += 4u )
+  {
+    const auto va = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( a + k ) );
+    const auto vb = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( b + k ) );
+    _mm256_storeu_si256( reinterpret_cast<__m256i*>( dst + k ), _mm256_andnot_si256( vb, va ) );
+  }
+#endif
+  for ( ; k < n; ++k )
+  {
+    dst[k] = a[k] & ~b[k];
+  }
+}
+
+/*! \brief Hash function for word arrays, e.g., to use them as keys */
+struct words_hash
+{
+  template<typename Words>
+  std::size_t operator()( const Words& words ) const
+  {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for ( auto w : words )
+    {
+      h ^= w + 0x9e3779b97f4a7c15ull + ( h << 6 ) + ( h >> 2 );
+    }
+    return static_cast<std::size_t>( h );
+  }
+};
+
+/*! \brief Returns true, if no bit is set */
+inline bool is_zero( const uint64_t* a, std::size_t n )
+{
+  for ( std::size_t k = 0u; k < n; ++k )
+  {
+    if ( a[k] )
+    {
+      return false;
+    }
+  }
+  return true;
+}
+}
+}
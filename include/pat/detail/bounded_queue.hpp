@@ -0,0 +1,150 @@
+/* pat: C++ dancing links solver
+ * Copyright (C) 2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file bounded_queue.hpp
+  \brief Bounded lock-free multi-producer multi-consumer queue
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace pat
+{
+
+namespace detail
+{
+
+/* Bounded queue as described by Dmitry Vyukov: each cell has a sequence
+   number that tells whether it is ready to be written (sequence equals the
+   enqueue position) or read (sequence equals the dequeue position plus one).
+   Producers and consumers claim positions with a CAS and never block each
+   other, except on a full or empty queue, where try_push and try_pop fail.
+   Values are exchanged with std::swap, such that buffers of moved-from values
+   are recycled instead of reallocated. */
+template<typename T>
+class bounded_queue
+{
+public:
+  /* capacity must be a power of 2 */
+  explicit bounded_queue( std::size_t capacity )
+      : mask( capacity - 1u ),
+        cells( new cell[capacity] )
+  {
+    assert( capacity >= 2u && ( capacity & mask ) == 0u );
+    for ( std::size_t i = 0u; i < capacity; ++i )
+    {
+      cells[i].sequence.store( i, std::memory_order_relaxed );
+    }
+  }
+
+  bool try_push( T& value )
+  {
+    auto pos = enqueue_pos.load( std::memory_order_relaxed );
+    while ( true )
+    {
+      auto& c = cells[pos & mask];
+      const auto seq = c.sequence.load( std::memory_order_acquire );
+      const auto diff = static_cast<std::ptrdiff_t>( seq ) - static_cast<std::ptrdiff_t>( pos );
+      if ( diff == 0 )
+      {
+        if ( enqueue_pos.compare_exchange_weak( pos, pos + 1u, std::memory_order_relaxed ) )
+        {
+          std::swap( c.value, value );
+          c.sequence.store( pos + 1u, std::memory_order_release );
+          return true;
+        }
+      }
+      else if ( diff < 0 )
+      {
+        return false; /* full */
+      }
+      else
+      {
+        pos = enqueue_pos.load( std::memory_order_relaxed );
+      }
+    }
+  }
+
+  bool try_pop( T& value )
+  {
+    auto pos = dequeue_pos.load( std::memory_order_relaxed );
+    while ( true )
+    {
+      auto& c = cells[pos & mask];
+      const auto seq = c.sequence.load( std::memory_order_acquire );
+      const auto diff = static_cast<std::ptrdiff_t>( seq ) - static_cast<std::ptrdiff_t>( pos + 1u );
+      if ( diff == 0 )
+      {
+        if ( dequeue_pos.compare_exchange_weak( pos, pos + 1u, std::memory_order_relaxed ) )
+        {
+          std::swap( c.value, value );
+          c.sequence.store( pos + mask + 1u, std::memory_order_release );
+          return true;
+        }
+      }
+      else if ( diff < 0 )
+      {
+        return false; /* empty */
+      }
+      else
+      {
+        pos = dequeue_pos.load( std::memory_order_relaxed );
+      }
+    }
+  }
+
+  std::size_t capacity() const
+  {
+    return mask + 1u;
+  }
+
+private:
+  static constexpr std::size_t cache_line = 64u;
+
+  struct cell
+  {
+    std::atomic<std::size_t> sequence;
+    T value;
+  };
+
+  const std::size_t mask;
+  std::unique_ptr<cell[]> cells;
+
+  /* separate cache lines for producers and consumers */
+  alignas( cache_line ) std::atomic<std::size_t> enqueue_pos{0u};
+  alignas( cache_line ) std::atomic<std::size_t> dequeue_pos{0u};
+};
+
+}
+
+}
@@ -0,0 +1,160 @@
+/* pat: C++ dancing links solver
+ * Copyright (C) 2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file failure_cache.hpp
+  \brief Bounded cache of failed residual problems
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "bitset.hpp"
+
+namespace pat
+{
+
+/*! \brief Counters of a failure cache */
+struct cache_statistics
+{
+  uint64_t lookups{};
+  uint64_t hits{};
+  uint64_t insertions{};
+  uint64_t evictions{};
+
+  inline double hit_rate() const
+  {
+    return lookups == 0u ? 0.0 : static_cast<double>( hits ) / lookups;
+  }
+};
+
+namespace detail
+{
+/*! \brief Set of word arrays with least-recently-used eviction
+
+  Keys and entries are allocated with (rebound copies of) ``Allocator``.
+*/
+template<typename Allocator = std::allocator<uint64_t>>
+class basic_failure_cache
+{
+  template<typename T>
+  using rebind_alloc = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+public:
+  using key_type = std::vector<uint64_t, rebind_alloc<uint64_t>>;
+
+  explicit basic_failure_cache( std::size_t capacity = 0u, const Allocator& alloc = Allocator() )
+      : capacity( capacity ),
+        order( alloc ),
+        index( 0u, words_hash(), std::equal_to<key_type>(), alloc ) {}
+
+  inline bool enabled() const
+  {
+    return capacity != 0u;
+  }
+
+  bool contains( const key_type& key )
+  {
+    ++stats.lookups;
+    const auto it = index.find( key );
+    if ( it == index.end() )
+    {
+      return false;
+    }
+
+    ++stats.hits;
+    order.splice( order.begin(), order, it->second );
+    return true;
+  }
+
+  void insert( const key_type& key )
+  {
+    if ( index.find( key ) != index.end() )
+    {
+      return;
+    }
+
+    if ( index.size() == capacity )
+    {
+      index.erase( *order.back() );
+      order.pop_back();
+      ++stats.evictions;
+    }
+
+    /* pointers to keys in an unordered_map stay valid on rehashing */
+    const auto it = index.emplace( key, order.end() ).first;
+    order.push_front( &it->first );
+    it->second = order.begin();
+    ++stats.insertions;
+  }
+
+  /*! \brief Removes all entries, the counters are kept */
+  void clear()
+  {
+    index.clear();
+    order.clear();
+  }
+
+  void reset_statistics()
+  {
+    stats = cache_statistics();
+  }
+
+  /*! \brief Clears the cache and its counters and sets a new capacity, 0 disables it */
+  void set_capacity( std::size_t new_capacity )
+  {
+    clear();
+    reset_statistics();
+    capacity = new_capacity;
+  }
+
+  inline const cache_statistics& statistics() const
+  {
+    return stats;
+  }
+
+private:
+  using order_type = std::list<const key_type*, rebind_alloc<const key_type*>>;
+  using index_type = std::unordered_map<key_type, typename order_type::iterator, words_hash, std::equal_to<key_type>, rebind_alloc<std::pair<const key_type, typename order_type::iterator>>>;
+
+  std::size_t capacity;
+  order_type order; /* most recently used first */
+  index_type index;
+  cache_statistics stats;
+};
+
+using failure_cache = basic_failure_cache<>;
+}
+}
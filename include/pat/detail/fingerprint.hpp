@@ -0,0 +1,142 @@
+/* pat: C++ dancing links solver
+ * Copyright (C) 2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file fingerprint.hpp
+  \brief Order-independent hashing of exact cover instances
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace pat
+{
+namespace detail
+{
+/*! \brief Finalizer of SplitMix64, a bijective mixing function */
+inline uint64_t mix64( uint64_t x )
+{
+  x += 0x9e3779b97f4a7c15ull;
+  x = ( x ^ ( x >> 30 ) ) * 0xbf58476d1ce4e5b9ull;
+  x = ( x ^ ( x >> 27 ) ) * 0x94d049bb133111ebull;
+  return x ^ ( x >> 31 );
+}
+
+/*! \brief Fingerprint of an instance given by the items of its options
+
+  Sets and multisets are hashed by summing the mixed hashes of their
+  elements, which does not depend on their order.  Hence, the fingerprint of
+  an option does not depend on the order of its items, and the fingerprint of
+  the instance does not depend on the order of its options.
+
+  If ``item_invariant`` is true, the fingerprint is also invariant under
+  renumbering items (primary among primary, secondary among secondary).  Item
+  identities are then replaced by colors computed with ``rounds`` rounds of
+  Weisfeiler-Leman refinement on the item-option incidence graph: an option's
+  color hashes the colors of its items, and an item's new color hashes its
+  old color and the colors of its options.  Isomorphic instances have equal
+  fingerprints, but some non-isomorphic instances that the refinement cannot
+  distinguish, e.g., certain regular ones, do as well.
+*/
+inline uint64_t instance_fingerprint( uint32_t primary_items, uint32_t secondary_items, const std::vector<std::vector<uint32_t>>& options, bool item_invariant, uint32_t rounds )
+{
+  const auto num_items = primary_items + secondary_items;
+
+  std::vector<uint64_t> color( num_items + 1u );
+  for ( auto j = 1u; j <= num_items; ++j )
+  {
+    color[j] = item_invariant ? ( j <= primary_items ? 1u : 2u ) : j;
+  }
+
+  if ( item_invariant )
+  {
+    std::vector<uint64_t> next( num_items + 1u );
+    for ( auto r = 0u; r < rounds; ++r )
+    {
+      next.assign( num_items + 1u, 0u );
+      for ( const auto& option : options )
+      {
+        uint64_t c = 0u;
+        for ( auto j : option )
+        {
+          c += mix64( color[j] );
+        }
+        c = mix64( c );
+        for ( auto j : option )
+        {
+          next[j] += c;
+        }
+      }
+      for ( auto j = 1u; j <= num_items; ++j )
+      {
+        color[j] = mix64( mix64( color[j] ) ^ next[j] );
+      }
+    }
+  }
+
+  uint64_t h = mix64( ( uint64_t( primary_items ) << 32u ) | secondary_items ) ^ ( item_invariant ? 0x5bd1e9955bd1e995ull : 0u );
+  for ( const auto& option : options )
+  {
+    uint64_t c = 0u;
+    for ( auto j : option )
+    {
+      c += mix64( color[j] );
+    }
+    h += mix64( c ^ 0x2545f4914f6cdd1dull );
+  }
+  return mix64( h );
+}
+
+/*! \brief Canonical form of an instance given by the items of its options
+
+  Returns the numbers of primary and secondary items, the number of options,
+  and then, for each option, its size followed by its sorted items, where the
+  options are sorted lexicographically.  Two instances have the same canonical
+  form if and only if they have the same options as sets of items, regardless
+  of their order.
+*/
+inline std::vector<uint32_t> canonical_form( uint32_t primary_items, uint32_t secondary_items, std::vector<std::vector<uint32_t>> options )
+{
+  for ( auto& option : options )
+  {
+    std::sort( option.begin(), option.end() );
+  }
+  std::sort( options.begin(), options.end() );
+
+  std::vector<uint32_t> form{primary_items, secondary_items, static_cast<uint32_t>( options.size() )};
+  for ( const auto& option : options )
+  {
+    form.push_back( static_cast<uint32_t>( option.size() ) );
+    form.insert( form.end(), option.begin(), option.end() );
+  }
+  return form;
+}
+}
+}
@@ -0,0 +1,110 @@
+/* pat: C++ dancing links solver
+ * Copyright (C) 2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file fixed_vector.hpp
+  \brief Vector with fixed capacity
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+namespace pat
+{
+namespace detail
+{
+/*! \brief Vector interface on top of ``std::array``
+
+  Provides the subset of the ``std::vector`` interface used by the solver, but
+  never allocates memory.  The size must never exceed ``N``.
+*/
+template<typename T, std::size_t N>
+class fixed_vector
+{
+public:
+  using value_type = T;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  fixed_vector() = default;
+
+  explicit fixed_vector( std::size_t n )
+  {
+    resize( n );
+  }
+
+  /* allocators are accepted for interface compatibility with std::vector */
+  template<typename Allocator>
+  explicit fixed_vector( const Allocator& ) {}
+
+  template<typename Allocator>
+  fixed_vector( std::size_t n, const Allocator& )
+  {
+    resize( n );
+  }
+
+  inline void resize( std::size_t n )
+  {
+    assert( n <= N );
+    for ( auto k = count; k < n; ++k )
+    {
+      elements[k] = T();
+    }
+    count = n;
+  }
+
+  inline void push_back( const T& value )
+  {
+    assert( count < N );
+    elements[count++] = value;
+  }
+
+  inline void clear() { count = 0u; }
+
+  inline std::size_t size() const { return count; }
+  static constexpr std::size_t capacity() { return N; }
+
+  inline T& operator[]( std::size_t k ) { return elements[k]; }
+  inline const T& operator[]( std::size_t k ) const { return elements[k]; }
+
+  inline T* data() { return elements.data(); }
+  inline const T* data() const { return elements.data(); }
+
+  inline iterator begin() { return data(); }
+  inline iterator end() { return data() + count; }
+  inline const_iterator begin() const { return data(); }
+  inline const_iterator end() const { return data() + count; }
+
+private:
+  std::array<T, N> elements{};
+  std::size_t count{0u};
+};
+}
+}
@@ -0,0 +1,68 @@
+/* pat: C++ dancing links solver
+ * Copyright (C) 2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file luby.hpp
+  \brief Luby restart sequence
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <cstdint>
+
+namespace pat
+{
+namespace detail
+{
+/*! \brief Returns the i-th element (1-based) of the Luby sequence
+
+  The sequence is 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, 1, 1, 2, 4, 8, ...  It is an
+  optimal universal restart schedule for Las Vegas algorithms (Luby, Sinclair,
+  and Zuckerman, 1993).
+*/
+inline uint64_t luby( uint64_t i )
+{
+  uint64_t k = 1u;
+  while ( ( uint64_t( 1 ) << k ) - 1u < i )
+  {
+    ++k;
+  }
+
+  while ( i != ( uint64_t( 1 ) << k ) - 1u )
+  {
+    i -= ( uint64_t( 1 ) << ( k - 1 ) ) - 1u;
+    k = 1u;
+    while ( ( uint64_t( 1 ) << k ) - 1u < i )
+    {
+      ++k;
+    }
+  }
+
+  return uint64_t( 1 ) << ( k - 1 );
+}
+}
+}
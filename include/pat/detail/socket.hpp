@@ -0,0 +1,199 @@
+/* pat: C++ dancing links solver
+ * Copyright (C) 2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file socket.hpp
+  \brief Message framing over Unix-domain sockets
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace pat
+{
+namespace detail
+{
+/* Messages consist of a header with the message type and the number of
+   payload words, followed by the payload as 64-bit words.  Longer payloads
+   are rejected, such that a garbled header cannot exhaust memory. */
+constexpr uint64_t max_message_words = uint64_t( 1u ) << 26u;
+
+inline bool write_all( int fd, const void* data, std::size_t bytes )
+{
+  auto p = static_cast<const char*>( data );
+  while ( bytes != 0u )
+  {
+    const auto n = ::send( fd, p, bytes, MSG_NOSIGNAL );
+    if ( n < 0 && errno == EINTR )
+    {
+      continue;
+    }
+    if ( n <= 0 )
+    {
+      return false;
+    }
+    p += n;
+    bytes -= n;
+  }
+  return true;
+}
+
+inline bool read_all( int fd, void* data, std::size_t bytes )
+{
+  auto p = static_cast<char*>( data );
+  while ( bytes != 0u )
+  {
+    const auto n = ::recv( fd, p, bytes, 0 );
+    if ( n < 0 && errno == EINTR )
+    {
+      continue;
+    }
+    if ( n <= 0 )
+    {
+      return false;
+    }
+    p += n;
+    bytes -= n;
+  }
+  return true;
+}
+
+template<typename Type>
+inline bool send_message( int fd, Type type, const std::vector<uint64_t>& payload = {} )
+{
+  const uint64_t header[2] = {static_cast<uint64_t>( type ), payload.size()};
+  return write_all( fd, header, sizeof( header ) ) && write_all( fd, payload.data(), payload.size() * sizeof( uint64_t ) );
+}
+
+template<typename Type>
+inline bool receive_message( int fd, Type& type, std::vector<uint64_t>& payload )
+{
+  uint64_t header[2];
+  if ( !read_all( fd, header, sizeof( header ) ) )
+  {
+    return false;
+  }
+  if ( header[1] > max_message_words )
+  {
+    return false;
+  }
+  type = static_cast<Type>( header[0] );
+  payload.resize( header[1] );
+  return read_all( fd, payload.data(), payload.size() * sizeof( uint64_t ) );
+}
+
+inline sockaddr_un socket_address( const std::string& path )
+{
+  sockaddr_un address;
+  std::memset( &address, 0, sizeof( address ) );
+  address.sun_family = AF_UNIX;
+  if ( path.size() >= sizeof( address.sun_path ) )
+  {
+    throw std::system_error( ENAMETOOLONG, std::generic_category(), path );
+  }
+  std::copy( path.begin(), path.end(), address.sun_path );
+  return address;
+}
+
+/* appends length-prefixed lists of words */
+template<typename T>
+inline void append_list( std::vector<uint64_t>& words, const std::vector<T>& list )
+{
+  words.push_back( list.size() );
+  words.insert( words.end(), list.begin(), list.end() );
+}
+
+/* reads length-prefixed lists of words starting at position pos, false if
+   a length exceeds the remaining words */
+inline bool read_lists( const std::vector<uint64_t>& words, std::size_t pos, std::vector<std::vector<uint64_t>>& lists )
+{
+  lists.clear();
+  while ( pos < words.size() )
+  {
+    const auto length = words[pos++];
+    if ( length > words.size() - pos )
+    {
+      return false;
+    }
+    lists.emplace_back( words.begin() + pos, words.begin() + pos + length );
+    pos += length;
+  }
+  return true;
+}
+
+/* socket listening at path, replaces a stale socket file */
+inline int listen_socket( const std::string& path )
+{
+  const auto address = socket_address( path );
+
+  const auto fd = ::socket( AF_UNIX, SOCK_STREAM, 0 );
+  if ( fd < 0 )
+  {
+    throw std::system_error( errno, std::generic_category(), "socket" );
+  }
+
+  ::unlink( path.c_str() );
+  if ( ::bind( fd, reinterpret_cast<const sockaddr*>( &address ), sizeof( address ) ) != 0 || ::listen( fd, SOMAXCONN ) != 0 )
+  {
+    const auto error = errno;
+    ::close( fd );
+    throw std::system_error( error, std::generic_category(), path );
+  }
+  return fd;
+}
+
+inline int connect_socket( const std::string& path )
+{
+  const auto address = socket_address( path );
+
+  const auto fd = ::socket( AF_UNIX, SOCK_STREAM, 0 );
+  if ( fd < 0 )
+  {
+    throw std::system_error( errno, std::generic_category(), "socket" );
+  }
+  if ( ::connect( fd, reinterpret_cast<const sockaddr*>( &address ), sizeof( address ) ) != 0 )
+  {
+    const auto error = errno;
+    ::close( fd );
+    throw std::system_error( error, std::generic_category(), path );
+  }
+  return fd;
+}
+}
+}
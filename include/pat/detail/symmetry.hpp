@@ -0,0 +1,110 @@
+/* pat: C++ dancing links solver
+ * Copyright (C) 2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file symmetry.hpp
+  \brief Permutation group utilities for symmetry breaking
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+namespace pat
+{
+namespace detail
+{
+using permutation = std::vector<uint32_t>;
+
+inline permutation identity_permutation( uint32_t n )
+{
+  permutation id( n );
+  for ( auto i = 0u; i < n; ++i )
+  {
+    id[i] = i;
+  }
+  return id;
+}
+
+inline permutation inverse_permutation( const permutation& perm )
+{
+  permutation inv( perm.size() );
+  for ( auto i = 0u; i < perm.size(); ++i )
+  {
+    assert( perm[i] < perm.size() );
+    inv[perm[i]] = i;
+  }
+  return inv;
+}
+
+/* computes (a o b)(i) = a(b(i)) */
+inline permutation compose_permutations( const permutation& a, const permutation& b )
+{
+  permutation c( b.size() );
+  for ( auto i = 0u; i < b.size(); ++i )
+  {
+    c[i] = a[b[i]];
+  }
+  return c;
+}
+
+/*! \brief Closes a set of generators under composition
+
+  Returns all elements of the generated group, except for the identity.  The
+  group is enumerated explicitly, which is only feasible for small groups, such
+  as the symmetries of a board.
+*/
+inline std::vector<permutation> permutation_group( const std::vector<permutation>& generators, uint32_t n )
+{
+  const auto id = identity_permutation( n );
+
+  std::set<permutation> elements{id};
+  std::vector<permutation> queue{id};
+
+  while ( !queue.empty() )
+  {
+    const auto p = queue.back();
+    queue.pop_back();
+
+    for ( const auto& g : generators )
+    {
+      auto q = compose_permutations( g, p );
+      if ( elements.insert( q ).second )
+      {
+        queue.push_back( q );
+      }
+    }
+  }
+
+  elements.erase( id );
+  return std::vector<permutation>( elements.begin(), elements.end() );
+}
+}
+}
@@ -0,0 +1,403 @@
+/* pat: C++ dancing links solver
+ * Copyright (C) 2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file distributed.hpp
+  \brief Coordinator and workers for multi-process search
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <poll.h>
+#include <unistd.h>
+
+#include "detail/socket.hpp"
+#include "search_limits.hpp"
+
+namespace pat
+{
+
+/*! \brief Aggregated result of a distributed search */
+struct distributed_result
+{
+  /*! \brief Number of solutions */
+  uint64_t count = 0u;
+
+  /*! \brief Solutions as option indices, if they were requested */
+  std::vector<std::vector<uint64_t>> solutions;
+
+  /*! \brief Number of prefixes that were solved by workers */
+  uint64_t prefixes = 0u;
+
+  /*! \brief Number of prefixes that were split again by workers */
+  uint64_t resplits = 0u;
+};
+
+/*! \cond PRIVATE */
+namespace detail
+{
+/* Message types, see detail/socket.hpp for the framing:
+
+     request  worker asks for work, no payload
+     work     prefix to solve: collect flag, option indices
+     result   solved prefix: count, then per solution its length and options
+     split    prefix exceeded the budget: per child prefix its length and options
+     done     no more work, the worker should terminate */
+enum class message : uint64_t
+{
+  request = 1u,
+  work,
+  result,
+  split,
+  done
+};
+
+}
+/*! \endcond PRIVATE */
+
+/*! \brief Hands out prefixes of the search tree to worker processes
+
+  The coordinator listens on a Unix-domain socket.  Workers, see
+  ``run_worker``, connect to it, repeatedly request a prefix, i.e., a list of
+  options that are chosen first, solve the residual problem, and send back the
+  number of solutions and optionally the solutions.  If a worker exceeds its
+  node budget on a prefix, it discards its partial result and sends back the
+  prefixes one level deeper instead, which are then handed out to idle
+  workers.  This balances the load dynamically, even if the subtrees have very
+  different sizes.  If a worker disconnects while solving a prefix, the prefix
+  is handed out again.
+
+  The socket is created by the constructor, such that workers can be started
+  as soon as the coordinator exists.  Socket errors are reported as
+  ``std::system_error``.
+*/
+class coordinator
+{
+public:
+  explicit coordinator( const std::string& path )
+      : path( path ),
+        listener( detail::listen_socket( path ) )
+  {
+  }
+
+  coordinator( const coordinator& ) = delete;
+  coordinator& operator=( const coordinator& ) = delete;
+
+  ~coordinator()
+  {
+    ::close( listener );
+    ::unlink( path.c_str() );
+  }
+
+  /*! \brief Solves the problem of ``solver`` with the connected workers
+
+    The initial prefixes are obtained by splitting the search tree of
+    ``solver`` at the given depth; the workers must have been set up with the
+    same options in the same order.  Returns once all prefixes have been
+    solved, after which all workers are told to terminate.
+  */
+  template<class Solver>
+  distributed_result run( Solver& solver, uint32_t depth = 2u, bool collect_solutions = false )
+  {
+    std::vector<std::vector<uint64_t>> prefixes;
+    for ( const auto& prefix : solver.split( {}, depth ) )
+    {
+      prefixes.emplace_back( prefix.begin(), prefix.end() );
+    }
+    return run( prefixes, collect_solutions );
+  }
+
+  /*! \brief Solves the given prefixes with the connected workers */
+  distributed_result run( const std::vector<std::vector<uint64_t>>& prefixes, bool collect_solutions = false )
+  {
+    distributed_result result;
+    pending.assign( prefixes.begin(), prefixes.end() );
+    collect = collect_solutions;
+    outstanding = 0u;
+
+    while ( !pending.empty() || outstanding != 0u )
+    {
+      std::vector<pollfd> fds( 1u + connections.size() );
+      fds[0] = {listener, POLLIN, 0};
+      for ( auto k = 0u; k < connections.size(); ++k )
+      {
+        fds[k + 1] = {connections[k].fd, POLLIN, 0};
+      }
+
+      if ( ::poll( fds.data(), fds.size(), -1 ) < 0 )
+      {
+        if ( errno == EINTR )
+        {
+          continue;
+        }
+        throw std::system_error( errno, std::generic_category(), "poll" );
+      }
+
+      if ( fds[0].revents & POLLIN )
+      {
+        const auto fd = ::accept( listener, nullptr, nullptr );
+        if ( fd >= 0 )
+        {
+          connections.emplace_back( fd );
+        }
+      }
+
+      for ( auto k = fds.size() - 1u; k != 0u; --k )
+      {
+        if ( fds[k].revents != 0 && !handle( connections[k - 1], result ) )
+        {
+          disconnect( k - 1 );
+        }
+      }
+
+      serve_waiting();
+    }
+
+    for ( auto& c : connections )
+    {
+      detail::send_message( c.fd, detail::message::done );
+      ::close( c.fd );
+    }
+    connections.clear();
+
+    return result;
+  }
+
+private:
+  struct connection
+  {
+    explicit connection( int fd ) : fd( fd ) {}
+
+    int fd;
+    bool waiting = false;
+    bool busy = false;
+    std::vector<uint64_t> prefix;
+  };
+
+  /* false, if the connection must be closed */
+  bool handle( connection& c, distributed_result& result )
+  {
+    detail::message type;
+    std::vector<uint64_t> payload;
+    if ( !detail::receive_message( c.fd, type, payload ) )
+    {
+      return false;
+    }
+
+    std::vector<std::vector<uint64_t>> lists;
+    switch ( type )
+    {
+    case detail::message::request:
+      /* a busy worker must answer first, its prefix is handed out again */
+      if ( c.busy )
+      {
+        return false;
+      }
+      c.waiting = true;
+      return true;
+
+    case detail::message::result:
+      if ( !c.busy || payload.empty() )
+      {
+        return false;
+      }
+      if ( !detail::read_lists( payload, 1u, lists ) )
+      {
+        return false;
+      }
+      result.count += payload[0];
+      for ( auto& solution : lists )
+      {
+        result.solutions.push_back( std::move( solution ) );
+      }
+      ++result.prefixes;
+      break;
+
+    case detail::message::split:
+      if ( !c.busy )
+      {
+        return false;
+      }
+      if ( !detail::read_lists( payload, 0u, lists ) )
+      {
+        return false;
+      }
+      for ( auto& prefix : lists )
+      {
+        pending.push_back( std::move( prefix ) );
+      }
+      ++result.resplits;
+      break;
+
+    default:
+      return false;
+    }
+
+    c.busy = false;
+    --outstanding;
+    return true;
+  }
+
+  void serve_waiting()
+  {
+    for ( auto k = 0u; k < connections.size() && !pending.empty(); ++k )
+    {
+      auto& c = connections[k];
+      if ( !c.waiting )
+      {
+        continue;
+      }
+
+      std::vector<uint64_t> payload{collect ? 1u : 0u};
+      payload.insert( payload.end(), pending.front().begin(), pending.front().end() );
+      if ( !detail::send_message( c.fd, detail::message::work, payload ) )
+      {
+        disconnect( k-- );
+        continue;
+      }
+
+      c.waiting = false;
+      c.busy = true;
+      c.prefix = std::move( pending.front() );
+      pending.pop_front();
+      ++outstanding;
+    }
+  }
+
+  void disconnect( std::size_t k )
+  {
+    auto& c = connections[k];
+    if ( c.busy )
+    {
+      pending.push_back( std::move( c.prefix ) );
+      --outstanding;
+    }
+    ::close( c.fd );
+    connections.erase( connections.begin() + k );
+  }
+
+private:
+  std::string path;
+  int listener = -1;
+  std::vector<connection> connections;
+  std::deque<std::vector<uint64_t>> pending;
+  uint64_t outstanding = 0u;
+  bool collect = false;
+};
+
+/*! \brief Solves prefixes handed out by a coordinator
+
+  Connects to the coordinator listening at ``path`` and solves prefixes until
+  the coordinator has no more work or closes the connection.  ``solver`` must
+  contain the same options in the same order as the solver of the coordinator.
+  If solving a prefix takes more than ``node_budget`` search nodes, the prefix
+  is split one level deeper and the new prefixes are sent back.  If the search
+  is cancelled with the cancellation flag of ``solver``'s limits, or a prefix
+  contains an unknown option, the worker disconnects, such that the
+  coordinator hands out the prefix again.  Returns the number of prefixes that
+  were solved.
+*/
+template<class Solver>
+uint64_t run_worker( const std::string& path, Solver& solver, uint64_t node_budget = 1u << 20u )
+{
+  using index_type = typename Solver::index_type;
+
+  const auto fd = detail::connect_socket( path );
+
+  const auto old_limits = solver.current_limits();
+  auto limits = old_limits;
+  limits.max_nodes = node_budget;
+  solver.set_limits( limits );
+
+  uint64_t solved = 0u;
+  detail::message type;
+  std::vector<uint64_t> payload;
+  while ( detail::send_message( fd, detail::message::request ) && detail::receive_message( fd, type, payload ) && type == detail::message::work && !payload.empty() )
+  {
+    const auto collect = payload[0] != 0u;
+    if ( std::any_of( payload.begin() + 1, payload.end(), [&]( uint64_t o ) { return o >= solver.num_options(); } ) )
+    {
+      break;
+    }
+    const std::vector<index_type> prefix( payload.begin() + 1, payload.end() );
+
+    std::vector<uint64_t> answer{0u};
+    const auto count = solver.solve_prefix( prefix, [&]( auto begin, auto end ) {
+      if ( collect )
+      {
+        answer.push_back( prefix.size() + ( end - begin ) );
+        answer.insert( answer.end(), prefix.begin(), prefix.end() );
+        for ( auto it = begin; it != end; ++it )
+        {
+          answer.push_back( solver.option_index( *it ) );
+        }
+      }
+      return true;
+    } );
+
+    if ( solver.status() == solve_status::complete )
+    {
+      answer[0] = count;
+      if ( !detail::send_message( fd, detail::message::result, answer ) )
+      {
+        break;
+      }
+      ++solved;
+    }
+    else if ( solver.status() == solve_status::budget_exhausted )
+    {
+      answer.clear();
+      for ( const auto& child : solver.split( prefix, 1u ) )
+      {
+        detail::append_list( answer, child );
+      }
+      if ( !detail::send_message( fd, detail::message::split, answer ) )
+      {
+        break;
+      }
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  solver.set_limits( old_limits );
+  ::close( fd );
+  return solved;
+}
+
+}
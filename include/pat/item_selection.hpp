@@ -33,16 +33,38 @@
 #pragma once
 
 #include <climits>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
-#include "solver.hpp"
+#include "storage.hpp"
 
 namespace pat
 {
 
+/*! \cond PRIVATE */
+namespace detail
+{
+/* item selection functions may implement dead_end( i ) to learn from failures */
+template<typename Fn, typename = void>
+struct has_dead_end : std::false_type
+{
+};
+
+template<typename Fn>
+struct has_dead_end<Fn, decltype( std::declval<Fn&>().dead_end( 0u ), void() )> : std::true_type
+{
+};
+}
+/*! \endcond PRIVATE */
+
 struct pick_first
 {
-  inline uint32_t operator()( const std::vector<item>& items, const std::vector<node>& nodes ) const
+  template<class Items, class Nodes>
+  inline auto operator()( const Items& items, const Nodes& nodes ) const
   {
     (void)nodes;
     return items[0].rlink;
@@ -51,11 +73,12 @@ struct pick_first
 
 struct mrv_heuristic
 {
-  inline uint32_t operator()( const std::vector<item>& items, const std::vector<node>& nodes ) const
+  template<class Items, class Nodes>
+  inline auto operator()( const Items& items, const Nodes& nodes ) const
   {
-    auto max = std::numeric_limits<int32_t>::max();
+    auto max = std::numeric_limits<typename Nodes::value_type::signed_index_type>::max();
     auto p = items[0].rlink;
-    auto i = 0;
+    decltype( p ) i = 0;
 
     while ( p != 0 )
     {
@@ -71,4 +94,97 @@ struct mrv_heuristic
     return i;
   }
 };
-}
\ No newline at end of file
+
+/*! \brief MRV heuristic with random tie-breaking
+
+  Chooses an item with the fewest remaining options, where ties are broken
+  uniformly at random.  Combined with ``solver::solve_with_restarts`` this
+  avoids heavy-tailed run times when searching for a first solution.
+*/
+struct random_mrv_heuristic
+{
+  explicit random_mrv_heuristic( uint64_t seed = 0u )
+      : rng( seed ) {}
+
+  template<class Items, class Nodes>
+  inline auto operator()( const Items& items, const Nodes& nodes )
+  {
+    auto max = std::numeric_limits<typename Nodes::value_type::signed_index_type>::max();
+    auto p = items[0].rlink;
+    decltype( p ) i = 0;
+    auto ties = 0u;
+
+    while ( p != 0 )
+    {
+      const auto l = nodes[p].len;
+      if ( l < max )
+      {
+        max = l;
+        i = p;
+        ties = 1u;
+      }
+      else if ( l == max && std::uniform_int_distribution<uint32_t>( 0u, ties++ )( rng ) == 0u )
+      {
+        i = p;
+      }
+      p = items[p].rlink;
+    }
+
+    return i;
+  }
+
+private:
+  std::mt19937_64 rng;
+};
+
+/*! \brief Adaptive weighted-degree heuristic (dom/wdeg)
+
+  Each item has a weight, initially 1, which is increased whenever the item is
+  chosen but has no options left, i.e., whenever it causes a dead end.  The
+  heuristic chooses an item that minimizes the ratio of its remaining options
+  and its weight, such that items which often fail are chosen early.  The
+  solver reports dead ends by calling ``dead_end``, which every item selection
+  function may implement.
+*/
+struct weighted_degree_heuristic
+{
+  template<class Items, class Nodes>
+  inline auto operator()( const Items& items, const Nodes& nodes )
+  {
+    if ( weights.size() < items.size() )
+    {
+      weights.resize( items.size(), 1.0 );
+    }
+
+    auto min = std::numeric_limits<double>::infinity();
+    auto p = items[0].rlink;
+    decltype( p ) i = 0;
+
+    while ( p != 0 )
+    {
+      const auto ratio = nodes[p].len / weights[p];
+      if ( ratio < min )
+      {
+        min = ratio;
+        i = p;
+      }
+      p = items[p].rlink;
+    }
+
+    return i;
+  }
+
+  inline void dead_end( uint64_t i )
+  {
+    weights[i] += 1.0;
+  }
+
+  inline double weight( uint64_t i ) const
+  {
+    return i < weights.size() ? weights[i] : 1.0;
+  }
+
+private:
+  std::vector<double> weights;
+};
+}
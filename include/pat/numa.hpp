@@ -0,0 +1,329 @@
+/* pat: C++ dancing links solver
+ * Copyright (C) 2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file numa.hpp
+  \brief Thread placement and memory locality on NUMA machines
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined( __linux__ )
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace pat
+{
+
+/*! \brief Placement of one worker thread and of its matrix
+
+  ``cpu`` is the CPU the worker was pinned to (or -1 if pinning failed), and
+  ``node`` is the NUMA node of that CPU.  ``pages`` is the number of memory
+  pages of the worker's ``items`` and ``nodes`` arrays, out of which
+  ``local_pages`` reside on the worker's NUMA node.  If the placement of pages
+  cannot be queried, both are 0.
+*/
+struct numa_worker_statistics
+{
+  int cpu = -1;
+  int node = 0;
+  uint64_t pages = 0u;
+  uint64_t local_pages = 0u;
+  uint64_t search_nodes = 0u;
+};
+
+/*! \brief Summary of the workers on one NUMA node (socket) */
+struct numa_node_statistics
+{
+  uint32_t workers = 0u;
+  uint64_t pages = 0u;
+  uint64_t local_pages = 0u;
+  uint64_t search_nodes = 0u;
+};
+
+/*! \brief Placement of all workers of a parallel search */
+struct numa_statistics
+{
+  std::vector<numa_worker_statistics> workers;
+
+  /*! \brief Summary per NUMA node */
+  std::map<int, numa_node_statistics> per_node() const
+  {
+    std::map<int, numa_node_statistics> summary;
+    for ( const auto& w : workers )
+    {
+      auto& s = summary[w.node];
+      ++s.workers;
+      s.pages += w.pages;
+      s.local_pages += w.local_pages;
+      s.search_nodes += w.search_nodes;
+    }
+    return summary;
+  }
+};
+
+/*! \cond PRIVATE */
+namespace detail
+{
+/* parses a CPU list of the format 0-3,8-11, malformed ranges are skipped */
+inline std::vector<std::pair<int, int>> parse_cpu_list( const std::string& list )
+{
+  std::vector<std::pair<int, int>> ranges;
+  std::size_t pos = 0u;
+
+  const auto number = [&]( int& value ) {
+    const auto begin = pos;
+    value = 0;
+    while ( pos < list.size() && pos - begin < 9u && std::isdigit( static_cast<unsigned char>( list[pos] ) ) )
+    {
+      value = 10 * value + ( list[pos++] - '0' );
+    }
+    return pos != begin;
+  };
+
+  while ( pos < list.size() )
+  {
+    int first, last;
+    if ( number( first ) )
+    {
+      last = first;
+      if ( pos < list.size() && list[pos] == '-' )
+      {
+        ++pos;
+        if ( !number( last ) )
+        {
+          last = -1;
+        }
+      }
+      if ( first <= last && ( pos == list.size() || list[pos] == ',' || std::isspace( static_cast<unsigned char>( list[pos] ) ) ) )
+      {
+        ranges.emplace_back( first, last );
+      }
+    }
+
+    /* continue after the next comma */
+    while ( pos < list.size() && list[pos++] != ',' )
+    {
+    }
+  }
+  return ranges;
+}
+
+/* NUMA node of each CPU according to sysfs, node IDs may be sparse and nodes
+   without CPUs are skipped */
+inline std::map<int, int> cpu_numa_nodes()
+{
+  std::map<int, int> nodes;
+#if defined( __linux__ )
+  const std::string path = "/sys/devices/system/node/";
+  const auto dir = opendir( path.c_str() );
+  if ( dir == nullptr )
+  {
+    return nodes;
+  }
+
+  while ( const auto entry = readdir( dir ) )
+  {
+    const std::string name = entry->d_name;
+    if ( name.size() < 5u || name.size() > 13u || name.compare( 0u, 4u, "node" ) != 0 || name.find_first_not_of( "0123456789", 4u ) != std::string::npos )
+    {
+      continue;
+    }
+    const auto node = std::atoi( name.c_str() + 4 );
+
+    std::ifstream in( path + name + "/cpulist" );
+    std::string list;
+    if ( !std::getline( in, list ) )
+    {
+      continue;
+    }
+    for ( const auto& range : parse_cpu_list( list ) )
+    {
+      for ( auto cpu = range.first; cpu <= range.second && cpu < CPU_SETSIZE; ++cpu )
+      {
+        nodes[cpu] = node;
+      }
+    }
+  }
+  closedir( dir );
+#endif
+  return nodes;
+}
+
+/* a CPU and its NUMA node */
+struct numa_cpu
+{
+  int cpu;
+  int node;
+};
+
+/* CPUs available to this process, interleaved across NUMA nodes, such that
+   consecutive workers are spread over all sockets; CPUs of unknown nodes are
+   assigned to node 0 */
+inline std::vector<numa_cpu> interleaved_cpus()
+{
+  std::map<int, std::vector<int>> by_node;
+#if defined( __linux__ )
+  cpu_set_t set;
+  CPU_ZERO( &set );
+  if ( sched_getaffinity( 0, sizeof( set ), &set ) == 0 )
+  {
+    const auto nodes = cpu_numa_nodes();
+    for ( auto cpu = 0; cpu < CPU_SETSIZE; ++cpu )
+    {
+      if ( CPU_ISSET( cpu, &set ) )
+      {
+        const auto it = nodes.find( cpu );
+        by_node[it == nodes.end() ? 0 : it->second].push_back( cpu );
+      }
+    }
+  }
+#endif
+
+  std::vector<numa_cpu> cpus;
+  for ( std::size_t k = 0u;; ++k )
+  {
+    auto added = false;
+    for ( const auto& p : by_node )
+    {
+      if ( k < p.second.size() )
+      {
+        cpus.push_back( {p.second[k], p.first} );
+        added = true;
+      }
+    }
+    if ( !added )
+    {
+      break;
+    }
+  }
+  return cpus;
+}
+
+/* pins the calling thread to a CPU, returns false on failure */
+inline bool pin_thread( int cpu )
+{
+#if defined( __linux__ )
+  cpu_set_t set;
+  CPU_ZERO( &set );
+  CPU_SET( cpu, &set );
+  return pthread_setaffinity_np( pthread_self(), sizeof( set ), &set ) == 0;
+#else
+  (void)cpu;
+  return false;
+#endif
+}
+
+/* counts the pages of [data, data + bytes) and those that reside on node */
+inline void count_pages( const void* data, std::size_t bytes, int node, numa_worker_statistics& stats )
+{
+#if defined( __linux__ ) && defined( SYS_move_pages )
+  if ( bytes == 0u )
+  {
+    return;
+  }
+
+  const auto page_size = static_cast<uintptr_t>( sysconf( _SC_PAGESIZE ) );
+  const auto first = reinterpret_cast<uintptr_t>( data ) & ~( page_size - 1u );
+  const auto last = reinterpret_cast<uintptr_t>( data ) + bytes;
+
+  std::vector<void*> pages;
+  for ( auto p = first; p < last; p += page_size )
+  {
+    pages.push_back( reinterpret_cast<void*>( p ) );
+  }
+  std::vector<int> status( pages.size() );
+
+  /* without target nodes, move_pages only reports where pages reside */
+  if ( syscall( SYS_move_pages, 0, pages.size(), pages.data(), nullptr, status.data(), 0 ) != 0 )
+  {
+    return;
+  }
+
+  for ( auto s : status )
+  {
+    if ( s >= 0 )
+    {
+      ++stats.pages;
+      if ( s == node )
+      {
+        ++stats.local_pages;
+      }
+    }
+  }
+#else
+  (void)data;
+  (void)bytes;
+  (void)node;
+  (void)stats;
+#endif
+}
+
+/* pins the calling worker thread to one of cpus, which are computed once
+   with interleaved_cpus, and returns its statistics skeleton */
+inline numa_worker_statistics place_worker( std::size_t index, const std::vector<numa_cpu>& cpus )
+{
+  numa_worker_statistics stats;
+  if ( !cpus.empty() )
+  {
+    const auto& cpu = cpus[index % cpus.size()];
+    if ( pin_thread( cpu.cpu ) )
+    {
+      stats.cpu = cpu.cpu;
+    }
+    stats.node = cpu.node;
+  }
+  return stats;
+}
+
+/* records where the matrix of a solver resides */
+template<typename Solver>
+inline void count_matrix_pages( const Solver& solver, numa_worker_statistics& stats )
+{
+  for ( const auto& region : solver.matrix_memory() )
+  {
+    count_pages( region.first, region.second, stats.node, stats );
+  }
+}
+}
+/*! \endcond PRIVATE */
+
+}
@@ -32,7 +32,22 @@
 
 #pragma once
 
+#include "allocators.hpp"
+#include "batch.hpp"
+#include "bitset_solver.hpp"
+#include "dancing_cells_solver.hpp"
+#if defined( __unix__ )
+#include "daemon.hpp"
+#include "distributed.hpp"
+#include "result_cache.hpp"
+#endif
 #include "item_selection.hpp"
+#include "numa.hpp"
+#include "portfolio.hpp"
+#include "search_limits.hpp"
+#include "search_task.hpp"
 #include "solution_callbacks.hpp"
+#include "solution_pipeline.hpp"
 #include "solver.hpp"
-#include "solver_types.hpp"
\ No newline at end of file
+#include "solver_types.hpp"
+#include "storage.hpp"
\ No newline at end of file
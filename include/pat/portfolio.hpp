@@ -0,0 +1,248 @@
+/* pat: C++ dancing links solver
+ * Copyright (C) 2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file portfolio.hpp
+  \brief Runs several solvers in parallel and returns the first answer
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "numa.hpp"
+#include "search_limits.hpp"
+
+namespace pat
+{
+
+/*! \brief Answer of a portfolio run */
+struct portfolio_result
+{
+  /*! \brief Value of ``winner`` if no solver found an answer */
+  static constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+  /*! \brief True, if the winner found a solution */
+  bool satisfiable = false;
+
+  /*! \brief Index of the solver that found the answer, or ``none`` */
+  std::size_t winner = none;
+
+  /*! \brief Option indices of the solution found by the winner */
+  std::vector<uint64_t> options;
+
+  /*! \brief ``complete``, if some solver found an answer, otherwise the status
+             of the solver that returned last */
+  solve_status status = solve_status::complete;
+
+  /*! \brief True, if some solver found an answer */
+  inline bool decided() const
+  {
+    return winner != none;
+  }
+};
+
+/*! \cond PRIVATE */
+namespace detail
+{
+class portfolio_state
+{
+public:
+  /* returns false if another solver has decided before */
+  template<typename Solver, typename Iterator>
+  bool decide( Solver& solver, std::size_t index, Iterator begin, Iterator end )
+  {
+    std::lock_guard<std::mutex> lock( mutex );
+    if ( result.decided() )
+    {
+      return false;
+    }
+    result.winner = index;
+    result.satisfiable = true;
+    for ( auto it = begin; it != end; ++it )
+    {
+      result.options.push_back( solver.option_index( *it ) );
+    }
+    cancel = true;
+    return true;
+  }
+
+  void unsatisfiable( std::size_t index )
+  {
+    std::lock_guard<std::mutex> lock( mutex );
+    if ( !result.decided() )
+    {
+      result.winner = index;
+      cancel = true;
+    }
+  }
+
+  void undecided( solve_status status )
+  {
+    std::lock_guard<std::mutex> lock( mutex );
+    if ( !result.decided() )
+    {
+      result.status = status;
+    }
+  }
+
+  template<typename Solver>
+  void run( Solver& solver, std::size_t index )
+  {
+    const auto old_limits = solver.current_limits();
+    auto limits = old_limits;
+    limits.cancel = &cancel;
+    solver.set_limits( limits );
+
+    solver.solve( [&]( auto begin, auto end ) {
+      decide( solver, index, begin, end );
+      return false;
+    } );
+
+    if ( solver.status() == solve_status::complete )
+    {
+      unsatisfiable( index );
+    }
+    else if ( solver.status() != solve_status::stopped )
+    {
+      undecided( solver.status() );
+    }
+
+    solver.set_limits( old_limits );
+  }
+
+  portfolio_result join( std::vector<std::thread>& threads )
+  {
+    for ( auto& t : threads )
+    {
+      t.join();
+    }
+
+    if ( result.decided() )
+    {
+      result.status = solve_status::complete;
+    }
+    return std::move( result );
+  }
+
+private:
+  std::atomic<bool> cancel{false};
+  std::mutex mutex;
+  portfolio_result result;
+};
+}
+/*! \endcond PRIVATE */
+
+/*! \brief Runs a portfolio of solvers and returns the first answer
+
+  Each solver runs in its own thread, and all solvers must encode the same
+  problem, but may differ in their item selection function, e.g., a
+  ``random_solver`` with different seeds, the order of options, or their
+  budgets.  As soon as one of them finds a solution or proves that there is
+  none, the others are cancelled, such that the latency is the one of the
+  fastest solver.  The solvers' own cancellation flags are replaced during the
+  run, all other limits are kept.  If no solver finds an answer, since all of
+  them exhausted their budgets, ``winner`` is ``portfolio_result::none``.
+*/
+template<typename... Solvers>
+portfolio_result solve_portfolio( Solvers&... solvers )
+{
+  std::vector<std::thread> threads;
+  threads.reserve( sizeof...( Solvers ) );
+  detail::portfolio_state state;
+
+  std::size_t index = 0;
+  (void)std::initializer_list<int>{( threads.emplace_back( [&state, &solvers, index]() { state.run( solvers, index ); } ), ++index, 0 )...};
+
+  return state.join( threads );
+}
+
+/*! \brief Runs a portfolio of solvers of the same type */
+template<typename Solver>
+portfolio_result solve_portfolio( std::vector<Solver>& solvers )
+{
+  std::vector<std::thread> threads;
+  threads.reserve( solvers.size() );
+  detail::portfolio_state state;
+
+  for ( std::size_t index = 0; index < solvers.size(); ++index )
+  {
+    threads.emplace_back( [&state, &solvers, index]() { state.run( solvers[index], index ); } );
+  }
+
+  return state.join( threads );
+}
+
+/*! \brief Runs a portfolio of solvers that are constructed by the workers
+
+  Unlike ``solve_portfolio``, this function creates the solvers in the worker
+  threads by calling ``make( index )`` for each ``index < workers``, which
+  must return a solver.  Before that, each worker is pinned to a CPU, where
+  consecutive workers are spread over all NUMA nodes.  Since the worker
+  allocates and initializes its own ``items`` and ``nodes`` arrays, their
+  pages are first touched by that worker and hence placed on its local NUMA
+  node, which avoids remote memory accesses in the search.  If ``stats`` is
+  given, it receives the placement of each worker and its matrix, which can be
+  summarized per NUMA node with ``numa_statistics::per_node``.
+*/
+template<typename Make>
+portfolio_result solve_portfolio_local( std::size_t workers, Make&& make, numa_statistics* stats = nullptr )
+{
+  std::vector<std::thread> threads;
+  threads.reserve( workers );
+  detail::portfolio_state state;
+  std::vector<numa_worker_statistics> placement( workers );
+  const auto cpus = detail::interleaved_cpus();
+
+  for ( std::size_t index = 0; index < workers; ++index )
+  {
+    threads.emplace_back( [&state, &make, &placement, &cpus, index]() {
+      placement[index] = detail::place_worker( index, cpus );
+      auto solver = make( index );
+      detail::count_matrix_pages( solver, placement[index] );
+      state.run( solver, index );
+      placement[index].search_nodes = solver.nodes_visited();
+    } );
+  }
+
+  auto result = state.join( threads );
+  if ( stats )
+  {
+    stats->workers = std::move( placement );
+  }
+  return result;
+}
+
+}
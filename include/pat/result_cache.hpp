@@ -0,0 +1,183 @@
+/* pat: C++ dancing links solver
+ * Copyright (C) 2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file result_cache.hpp
+  \brief On-disk cache of solution counts
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include "detail/failure_cache.hpp"
+#include "search_limits.hpp"
+
+namespace pat
+{
+
+/*! \brief Solution counts stored on disk, keyed by fingerprints
+
+  Each count is stored in its own file in ``directory``, named after the
+  fingerprint, which is written to a temporary file first and then renamed,
+  such that several processes and threads can share the cache.  The directory is created
+  if it does not exist.
+
+  Fingerprints are hashes and may collide.  Therefore, every entry also
+  stores the canonical form of its problem, and a lookup only hits if the
+  stored form equals the requested one.  On a collision, the later entry
+  replaces the earlier one.
+*/
+class result_cache
+{
+public:
+  explicit result_cache( const std::string& directory )
+      : directory( directory )
+  {
+    if ( ::mkdir( directory.c_str(), 0755 ) != 0 && errno != EEXIST )
+    {
+      throw std::system_error( errno, std::generic_category(), directory );
+    }
+  }
+
+  /*! \brief Looks up the count of a problem, returns true on a hit */
+  bool lookup( uint64_t key, const std::vector<uint32_t>& form, uint64_t& count )
+  {
+    ++stats.lookups;
+    std::ifstream in( filename( key ) );
+    std::size_t size;
+    if ( !( in >> count >> size ) || size != form.size() )
+    {
+      return false;
+    }
+    for ( auto word : form )
+    {
+      uint32_t stored;
+      if ( !( in >> stored ) || stored != word )
+      {
+        return false;
+      }
+    }
+    ++stats.hits;
+    return true;
+  }
+
+  /*! \brief Stores the count of a problem */
+  void store( uint64_t key, const std::vector<uint32_t>& form, uint64_t count )
+  {
+    const auto name = filename( key );
+    const auto temporary = fmt::format( "{}.{}.{}.tmp", name, ::getpid(), next_temporary() );
+    {
+      std::ofstream out( temporary );
+      out << count << '\n'
+          << form.size() << '\n';
+      for ( auto word : form )
+      {
+        out << word << ' ';
+      }
+      out << '\n';
+      if ( !out )
+      {
+        return;
+      }
+    }
+    if ( std::rename( temporary.c_str(), name.c_str() ) != 0 )
+    {
+      std::remove( temporary.c_str() );
+      return;
+    }
+    ++stats.insertions;
+  }
+
+  /*! \brief Lookup, hit, and insertion counters */
+  const cache_statistics& statistics() const
+  {
+    return stats;
+  }
+
+private:
+  std::string filename( uint64_t key ) const
+  {
+    return fmt::format( "{}/{:016x}.count", directory, key );
+  }
+
+  /* distinguishes temporary files of the threads of one process */
+  static uint64_t next_temporary()
+  {
+    static std::atomic<uint64_t> counter{0u};
+    return counter++;
+  }
+
+private:
+  std::string directory;
+  cache_statistics stats;
+};
+
+/*! \brief Counts solutions, using a result cache
+
+  Returns the stored count if the cache contains the canonical form of
+  ``solver``, i.e., the same problem up to the order of options and of the
+  items within options.  Otherwise, the solutions are counted with ``solve``
+  and the count is stored, unless the search was stopped by its limits.
+  Renumbered problems are not shared, since their canonical forms differ.
+  The count includes all symmetric copies, see ``symmetric_solutions``, such
+  that it does not depend on declared symmetries.
+*/
+template<class Solver>
+uint64_t solve_cached( Solver& solver, result_cache& cache )
+{
+  const auto key = solver.fingerprint();
+  const auto form = solver.canonical_form();
+
+  uint64_t count;
+  if ( cache.lookup( key, form, count ) )
+  {
+    return count;
+  }
+
+  solver.solve();
+  count = solver.symmetric_solutions();
+  if ( solver.status() == solve_status::complete )
+  {
+    cache.store( key, form, count );
+  }
+  return count;
+}
+
+}
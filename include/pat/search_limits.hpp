@@ -0,0 +1,110 @@
+/* pat: C++ dancing links solver
+ * Copyright (C) 2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file search_limits.hpp
+  \brief Budgets, status, and progress of a search
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace pat
+{
+/*! \brief Reason why a search returned */
+enum class solve_status
+{
+  complete,         /*!< the whole search space was explored */
+  stopped,          /*!< the solution callback returned false */
+  budget_exhausted, /*!< the node or time budget was exhausted */
+  cancelled         /*!< the cancellation flag was set */
+};
+
+/*! \brief Budgets for a search
+
+  The node budget is checked in every search node, the time budget and the
+  cancellation flag are checked every ``check_interval`` nodes.  A default
+  constructed object imposes no limits.
+*/
+struct search_limits
+{
+  uint64_t max_nodes = std::numeric_limits<uint64_t>::max();
+  std::chrono::steady_clock::duration max_time = std::chrono::steady_clock::duration::max();
+  const std::atomic<bool>* cancel = nullptr;
+  uint64_t check_interval = 1024u;
+};
+
+/*! \brief Position of a search in the search tree
+
+  At level ``k < level``, the search branches on an item with ``lengths[k]``
+  options and currently explores the option at (0-based) position
+  ``positions[k]``.  The estimated fraction of the search tree that has been
+  explored is computed as described by Knuth in Section 7.2.2 of TAOCP, i.e.,
+  assuming that all subtrees at each level are of equal size.  It omits the
+  contribution of the current node, such that it never decreases during the
+  search.
+*/
+struct search_progress
+{
+  uint64_t nodes{};
+  uint32_t level{};
+  std::vector<uint32_t> positions;
+  std::vector<uint32_t> lengths;
+  double estimate{};
+};
+
+/*! \cond PRIVATE */
+namespace detail
+{
+inline double estimate_progress( const std::vector<uint32_t>& positions, const std::vector<uint32_t>& lengths, uint32_t level )
+{
+  auto estimate = 0.0, scale = 1.0;
+  for ( auto k = 0u; k < level; ++k )
+  {
+    scale /= lengths[k];
+    estimate += positions[k] * scale;
+  }
+  return estimate;
+}
+
+inline std::chrono::steady_clock::time_point deadline_after( std::chrono::steady_clock::duration duration )
+{
+  const auto now = std::chrono::steady_clock::now();
+  if ( duration >= std::chrono::steady_clock::time_point::max() - now )
+  {
+    return std::chrono::steady_clock::time_point::max();
+  }
+  return now + duration;
+}
+}
+/*! \endcond PRIVATE */
+}
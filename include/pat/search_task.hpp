@@ -0,0 +1,174 @@
+/* pat: C++ dancing links solver
+ * Copyright (C) 2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file search_task.hpp
+  \brief Resumable search as a C++20 coroutine
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#if defined( __has_include )
+#if __has_include( <coroutine> ) && defined( __cpp_impl_coroutine )
+#define PAT_HAS_COROUTINES
+
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <utility>
+
+#include "solution_callbacks.hpp"
+
+namespace pat
+{
+
+/*! \brief Search that suspends after each slice of work
+
+  Returned by ``solve_stepwise``.  Each call to ``resume`` runs one slice of
+  the search and returns false once the search has finished.
+*/
+class search_task
+{
+public:
+  struct promise_type
+  {
+    uint64_t solutions = 0u;
+    std::exception_ptr exception;
+
+    search_task get_return_object()
+    {
+      return search_task( std::coroutine_handle<promise_type>::from_promise( *this ) );
+    }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+
+    std::suspend_always yield_value( uint64_t count ) noexcept
+    {
+      solutions = count;
+      return {};
+    }
+
+    void return_value( uint64_t count ) noexcept
+    {
+      solutions = count;
+    }
+
+    void unhandled_exception()
+    {
+      exception = std::current_exception();
+    }
+  };
+
+  search_task( search_task&& other ) noexcept
+      : handle( std::exchange( other.handle, nullptr ) )
+  {
+  }
+
+  search_task& operator=( search_task&& other ) noexcept
+  {
+    if ( this != &other )
+    {
+      if ( handle )
+      {
+        handle.destroy();
+      }
+      handle = std::exchange( other.handle, nullptr );
+    }
+    return *this;
+  }
+
+  ~search_task()
+  {
+    if ( handle )
+    {
+      handle.destroy();
+    }
+  }
+
+  /*! \brief Runs the next slice, returns true if the search is not finished */
+  bool resume()
+  {
+    if ( !handle || handle.done() )
+    {
+      return false;
+    }
+    handle.resume();
+    if ( handle.promise().exception )
+    {
+      std::rethrow_exception( handle.promise().exception );
+    }
+    return !handle.done();
+  }
+
+  /*! \brief True, if the search has finished */
+  bool done() const
+  {
+    return !handle || handle.done();
+  }
+
+  /*! \brief Number of solutions found so far */
+  uint64_t solutions() const
+  {
+    return handle ? handle.promise().solutions : 0u;
+  }
+
+private:
+  explicit search_task( std::coroutine_handle<promise_type> handle )
+      : handle( handle )
+  {
+  }
+
+  std::coroutine_handle<promise_type> handle;
+};
+
+/*! \brief Runs ``solver.solve_steps`` in slices of ``nodes_per_slice`` nodes
+
+  The coroutine starts suspended; each ``resume`` of the returned task runs
+  one slice.  The callback is copied into the coroutine, the solver must
+  outlive the task.
+*/
+template<class Solver, typename Fn = decltype( just_count )&>
+search_task solve_stepwise( Solver& solver, uint64_t nodes_per_slice, Fn fn = just_count )
+{
+  uint64_t solutions = 0u;
+  while ( true )
+  {
+    solutions += solver.solve_steps( nodes_per_slice, std::chrono::steady_clock::duration::max(), fn );
+    if ( !solver.is_paused() )
+    {
+      co_return solutions;
+    }
+    co_yield solutions;
+  }
+}
+
+}
+
+#endif
+#endif
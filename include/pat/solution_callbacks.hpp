@@ -33,16 +33,56 @@
 #pragma once
 
 #include <cstdint>
-#include <vector>
+#include <utility>
 
 namespace pat
 {
 /*! \brief Iterator type to access solutions
 
   To avoid copying, a solution is passed to the solution callback in terms of an
-  iterator pair.
+  iterator pair.  The iterators are pointers into the solver's stack, such that
+  they do not depend on how the solver stores it.  This is the iterator type of
+  solvers with 32-bit indexes; in general, the iterators are pointers to the
+  solver's ``index_type``.
 */
-using solution_iterator = std::vector<uint32_t>::const_iterator;
+using solution_iterator = const uint32_t*;
+
+/*! \cond PRIVATE */
+namespace detail
+{
+struct just_count_fn
+{
+  template<typename Iterator>
+  inline bool operator()( Iterator begin, Iterator end ) const
+  {
+    (void)begin;
+    (void)end;
+    return true;
+  }
+};
+
+struct stop_after_first_fn
+{
+  template<typename Iterator>
+  inline bool operator()( Iterator begin, Iterator end ) const
+  {
+    (void)begin;
+    (void)end;
+    return false;
+  }
+};
+
+struct do_nothing_fn
+{
+  template<typename Iterator>
+  inline void operator()( Iterator begin, Iterator end ) const
+  {
+    (void)begin;
+    (void)end;
+  }
+};
+}
+/*! \endcond PRIVATE */
 
 /*! \brief Do nothing, just count all solutions
 
@@ -50,24 +90,14 @@ using solution_iterator = std::vector<uint32_t>::const_iterator;
   that all solutions are going to be visited.  This is the default solution
   callback that is passed to ``pat::solver::solve``.
 */
-inline bool just_count( solution_iterator begin, solution_iterator end )
-{
-  (void)begin;
-  (void)end;
-  return true;
-}
+constexpr detail::just_count_fn just_count{};
 
 /*! \brief Do nothing, but stop after first solution
 
   This solution callback can be used if one is iterested in finding whether
   there is a solution or not, but the actual solution is not important.
 */
-inline bool stop_after_first( solution_iterator begin, solution_iterator end )
-{
-  (void)begin;
-  (void)end;
-  return false;
-}
+constexpr detail::stop_after_first_fn stop_after_first{};
 
 /*! \brief Do nothing, in a meta solution callback
 
@@ -76,11 +106,7 @@ inline bool stop_after_first( solution_iterator begin, solution_iterator end )
   meta solution callbacks do not return a truth value, since the meta callback
   decides whether to continue finding solutions or not.
 */
-inline void do_nothing( solution_iterator begin, solution_iterator end )
-{
-  (void)begin;
-  (void)end;
-}
+constexpr detail::do_nothing_fn do_nothing{};
 
 /*! \cond PRIVATE */
 namespace detail
@@ -90,9 +116,10 @@ struct stop_after_impl
 {
   stop_after_impl( uint32_t max_solutions, Fn&& fn )
       : max_solutions( max_solutions ),
-        fn( std::move( fn ) ) {}
+        fn( std::forward<Fn>( fn ) ) {}
 
-  bool operator()( solution_iterator begin, solution_iterator end )
+  template<typename Iterator>
+  bool operator()( Iterator begin, Iterator end )
   {
     fn( begin, end );
     return ++counter != max_solutions;
@@ -113,9 +140,9 @@ private:
   callback which handles the actual solution.  By default, no action is
   performed on the solution.
 */
-template<typename Fn = decltype( do_nothing )>
+template<typename Fn = decltype( do_nothing )&>
 inline auto stop_after( uint32_t max_solutions, Fn&& fn = do_nothing )
 {
-  return detail::stop_after_impl<Fn>( max_solutions, std::move( fn ) );
+  return detail::stop_after_impl<Fn>( max_solutions, std::forward<Fn>( fn ) );
 }
 }
@@ -0,0 +1,208 @@
+/* pat: C++ dancing links solver
+ * Copyright (C) 2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file solution_pipeline.hpp
+  \brief Hands off solutions to consumer threads
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "detail/bounded_queue.hpp"
+
+namespace pat
+{
+
+/*! \brief Processes solutions in consumer threads while the search continues
+
+  The callback returned by ``callback`` converts each solution into a record
+  of option indices and pushes it into a bounded lock-free queue, from which
+  the consumer threads pop records and call ``consumer`` on them.  If the
+  queue is full, the search thread waits until a consumer has made room, such
+  that memory stays bounded if the consumers are slower than the search; the
+  number of such stalls is counted.  With more than one consumer thread,
+  ``consumer`` is called concurrently and must be thread-safe.  Records are
+  recycled, such that no memory is allocated in steady state.  Several search
+  threads may push into the same pipeline, each with its own callback.  Idle
+  consumers back off from yielding to sleeping, such that they do not occupy
+  a core when solutions are rare.
+
+  ``close`` (also called by the destructor) waits until all records have been
+  processed and joins the consumer threads.
+*/
+template<typename Consumer>
+class solution_pipeline
+{
+public:
+  /*! \brief Starts the consumer threads
+
+    ``capacity`` is the number of records in the queue and must be a power of
+    2.
+  */
+  explicit solution_pipeline( Consumer consumer, std::size_t consumers = 1u, std::size_t capacity = 1024u )
+      : consumer( std::move( consumer ) ),
+        queue( capacity )
+  {
+    for ( auto k = 0u; k < consumers; ++k )
+    {
+      threads.emplace_back( [this]() { consume(); } );
+    }
+  }
+
+  solution_pipeline( const solution_pipeline& ) = delete;
+  solution_pipeline& operator=( const solution_pipeline& ) = delete;
+
+  ~solution_pipeline()
+  {
+    close();
+  }
+
+  /*! \brief Solution callback for ``solver`` that pushes records
+
+    Each callback owns the record it fills, hence every search thread must
+    use its own callback.
+  */
+  template<class Solver>
+  auto callback( Solver& solver )
+  {
+    return [this, &solver, record = std::vector<uint64_t>()]( auto begin, auto end ) mutable {
+      record.clear();
+      for ( auto it = begin; it != end; ++it )
+      {
+        record.push_back( solver.option_index( *it ) );
+      }
+      push( record );
+      return true;
+    };
+  }
+
+  /*! \brief Waits for all records to be processed */
+  void close()
+  {
+    done.store( true, std::memory_order_release );
+    for ( auto& t : threads )
+    {
+      t.join();
+    }
+    threads.clear();
+  }
+
+  /*! \brief Number of times the search waited for a full queue */
+  uint64_t stalls() const
+  {
+    return num_stalls.load( std::memory_order_relaxed );
+  }
+
+private:
+  void push( std::vector<uint64_t>& record )
+  {
+    if ( queue.try_push( record ) )
+    {
+      return;
+    }
+
+    num_stalls.fetch_add( 1u, std::memory_order_relaxed );
+    while ( !queue.try_push( record ) )
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  void consume()
+  {
+    std::vector<uint64_t> local;
+    auto idle = 0u;
+    while ( true )
+    {
+      if ( queue.try_pop( local ) )
+      {
+        consumer( local );
+        idle = 0u;
+      }
+      else if ( done.load( std::memory_order_acquire ) )
+      {
+        /* records pushed before done was set are visible now */
+        if ( !queue.try_pop( local ) )
+        {
+          return;
+        }
+        consumer( local );
+      }
+      else
+      {
+        wait( idle++ );
+      }
+    }
+  }
+
+  /* yields first, then sleeps for up to a millisecond */
+  static void wait( uint32_t idle )
+  {
+    if ( idle < 64u )
+    {
+      std::this_thread::yield();
+    }
+    else
+    {
+      std::this_thread::sleep_for( std::chrono::microseconds( 1u << std::min( idle - 64u, 10u ) ) );
+    }
+  }
+
+private:
+  Consumer consumer;
+  detail::bounded_queue<std::vector<uint64_t>> queue;
+  std::vector<std::thread> threads;
+  std::atomic<bool> done{false};
+  std::atomic<uint64_t> num_stalls{0u};
+};
+
+/*! \brief Solves and processes solutions in consumer threads
+
+  Calls ``consumer`` with the option indices of each solution from
+  ``consumers`` threads, see ``solution_pipeline``, and returns once all
+  solutions have been processed.
+*/
+template<class Solver, class Consumer>
+uint32_t solve_pipelined( Solver& solver, Consumer&& consumer, std::size_t consumers = 1u, std::size_t capacity = 1024u )
+{
+  solution_pipeline<std::decay_t<Consumer>> pipeline( std::forward<Consumer>( consumer ), consumers, capacity );
+  const auto solutions = solver.solve( pipeline.callback( solver ) );
+  pipeline.close();
+  return solutions;
+}
+
+}
@@ -32,9 +32,19 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <fmt/format.h>
@@ -43,49 +53,174 @@
 #include <range/v3/view/iota.hpp>
 #include <range/v3/view/zip_with.hpp>
 
+#include "detail/bitset.hpp"
+#include "detail/failure_cache.hpp"
+#include "detail/fingerprint.hpp"
+#include "detail/luby.hpp"
 #include "detail/range.hpp"
+#include "detail/symmetry.hpp"
+#include "item_selection.hpp"
+#include "search_limits.hpp"
 #include "solution_callbacks.hpp"
+#include "storage.hpp"
 
 namespace pat
 {
 
-struct item
+/*! \brief Number of solutions of a puzzle, see ``solver::check_uniqueness`` */
+enum class uniqueness
 {
-  uint32_t index{};
-  uint32_t llink{};
-  uint32_t rlink{};
+  none,    /*!< there is no solution */
+  unique,  /*!< there is exactly one solution */
+  multiple /*!< there are at least two solutions */
 };
 
-struct node
+/*! \cond PRIVATE */
+namespace detail
 {
-  union {
-    int32_t len{};
-    int32_t top;
-  };
-  uint32_t ulink{};
-  uint32_t dlink{};
+template<typename Fn>
+struct incumbent_search
+{
+  Fn& fn;
+  double best = std::numeric_limits<double>::infinity();
+
+  inline double threshold() const { return best; }
+
+  template<typename Iterator>
+  bool solution( double cost, Iterator begin, Iterator end )
+  {
+    best = cost;
+    return fn( begin, end );
+  }
+};
+
+template<typename Index>
+struct top_k_search
+{
+  using entry = std::pair<double, std::vector<Index>>;
+
+  explicit top_k_search( uint32_t k ) : k( k ) {}
+
+  static bool less_cost( const entry& a, const entry& b ) { return a.first < b.first; }
+
+  inline double threshold() const
+  {
+    return heap.size() < k ? std::numeric_limits<double>::infinity() : heap.front().first;
+  }
+
+  template<typename Iterator>
+  bool solution( double cost, Iterator begin, Iterator end )
+  {
+    heap.emplace_back( cost, std::vector<Index>( begin, end ) );
+    std::push_heap( heap.begin(), heap.end(), less_cost );
+    if ( heap.size() > k )
+    {
+      std::pop_heap( heap.begin(), heap.end(), less_cost );
+      heap.pop_back();
+    }
+    return true;
+  }
+
+  uint32_t k;
+  std::vector<entry> heap; /* max-heap on cost */
 };
+}
+/*! \endcond PRIVATE */
 
-template<typename ItemSelectionFn>
+template<typename ItemSelectionFn, typename Storage = dynamic_storage>
 class solver
 {
 public:
-  explicit solver( uint32_t primary_items, uint32_t secondary_items = 0u, ItemSelectionFn&& item_selection = ItemSelectionFn() )
-      : items( primary_items + secondary_items + 1 ),
-        nodes( primary_items + secondary_items + 2 ),
+  using index_type = typename Storage::index_type;
+  using signed_index_type = std::make_signed_t<index_type>;
+  using item_type = basic_item<index_type>;
+  using node_type = basic_node<index_type>;
+  using allocator_type = typename Storage::allocator_type;
+
+private:
+  /* sets of covered items, as keys of the failure cache and the sample memo */
+  using key_type = typename Storage::template buffer_type<uint64_t>;
+  using memo_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<std::pair<const key_type, uint64_t>>;
+
+public:
+  /*! \brief Constructs a solver whose sizes are given by the storage policy */
+  template<typename S = Storage, typename = std::enable_if_t<S::fixed_size>>
+  solver( ItemSelectionFn&& item_selection = ItemSelectionFn() )
+      : solver( S::primary_items, S::secondary_items, std::move( item_selection ) )
+  {
+  }
+
+  explicit solver( uint32_t primary_items, uint32_t secondary_items = 0u, ItemSelectionFn&& item_selection = ItemSelectionFn(), const allocator_type& alloc = allocator_type() )
+      : items( primary_items + secondary_items + 1, alloc ),
+        nodes( primary_items + secondary_items + 2, alloc ),
+        xs( alloc ),
         primary_items( primary_items ),
         secondary_items( secondary_items ),
         num_items( primary_items + secondary_items ),
+        option_begin( alloc ),
+        option_chosen( alloc ),
+        item_used( alloc ),
+        item_given( alloc ),
+        option_costs( alloc ),
+        node_cost( alloc ),
+        node_share( alloc ),
+        failures( 0u, alloc ),
+        covered_key( alloc ),
+        prefix_key( alloc ),
+        level_solutions( alloc ),
+        sample_memo( 0u, detail::words_hash(), std::equal_to<key_type>(), alloc ),
+        sample_key( alloc ),
+        component_parent( alloc ),
+        touched_secondary( alloc ),
+        component_index( alloc ),
+        component_stack( alloc ),
         item_selection( std::move( item_selection ) )
   {
     initialize_items();
   }
 
+  /*! \brief Removes all options and symmetries and sets new numbers of items
+
+    The solver can then be used for a new problem.  Its buffers keep their
+    capacity, such that solving many small problems one after another with the
+    same solver does not allocate memory once the buffers are large enough.
+    Limits, progress reporting, and the failure cache capacity are kept.
+  */
+  void reset( uint32_t new_primary_items, uint32_t new_secondary_items = 0u )
+  {
+    abort_steps();
+    primary_items = new_primary_items;
+    secondary_items = new_secondary_items;
+    num_items = primary_items + secondary_items;
+    m = 0;
+
+    items.clear();
+    items.resize( num_items + 1 );
+    nodes.clear();
+    nodes.resize( num_items + 2 );
+
+    option_symmetries.clear();
+    item_symmetries.clear();
+    symmetries.clear();
+    inverse_symmetries.clear();
+    symmetries_dirty = false;
+    option_begin.clear();
+    option_costs.clear();
+    failures.clear();
+    prefix_key.clear();
+    sample_memo.clear();
+
+    initialize_items();
+  }
+
   template<class Items>
   void add_option( const Items& opt_items )
   {
+    assert( !paused );
+    /* option indexes are stored negated in spacers */
+    assert( m < std::numeric_limits<signed_index_type>::max() );
     /* store current last item */
-    const auto p = nodes.size() - 1;
+    const index_type p = nodes.size() - 1;
     auto k = 0u;
 
     for ( auto j : opt_items )
@@ -94,11 +229,12 @@ public:
       {
         assert( false );
       }
+      assert( nodes.size() < std::numeric_limits<index_type>::max() );
       nodes[j].len++;
       const auto q = nodes[j].ulink;
       nodes[j].ulink = nodes[q].dlink = nodes.size();
 
-      node next_node;
+      node_type next_node;
       next_node.ulink = q;
       next_node.dlink = j;
       next_node.top = j;
@@ -109,29 +245,330 @@ public:
 
     ++m;
     nodes[p].dlink = p + k;
+    failures.clear();
+    if ( !option_symmetries.empty() || !item_symmetries.empty() )
+    {
+      symmetries_dirty = true;
+    }
 
     /* next spacer */
-    node spacer;
+    assert( nodes.size() < std::numeric_limits<index_type>::max() );
+    node_type spacer;
     spacer.top = -m;
     spacer.ulink = p + 1;
     nodes.push_back( spacer );
   }
 
-  template<typename Fn = decltype( just_count )>
+  /*! \brief Adds an option with a cost
+
+    Costs are used by ``solve_min_cost``, they must be non-negative.  Options
+    that are added without a cost have cost 0.
+  */
+  template<class Items>
+  void add_option( const Items& opt_items, double cost )
+  {
+    assert( cost >= 0.0 );
+    add_option( opt_items );
+    option_costs.resize( m, 0.0 );
+    option_costs.back() = cost;
+  }
+
+  /*! \brief Declares a symmetry in terms of an option permutation
+
+    The permutation maps each option index (in the order in which options were
+    added, starting from 0) to its image under an automorphism of the problem.
+    Only generators need to be declared, ``solve`` computes the group they
+    generate.  If symmetries are declared, ``solve`` only visits the
+    lexicographically smallest solution of each orbit and prunes all branches
+    that cannot lead to such a solution.
+  */
+  void add_symmetry( const std::vector<uint32_t>& option_permutation )
+  {
+    assert( option_permutation.size() == static_cast<uint32_t>( m ) );
+    abort_steps();
+    option_symmetries.push_back( option_permutation );
+    symmetries_dirty = true;
+  }
+
+  /*! \brief Declares a symmetry in terms of an item permutation
+
+    The permutation maps each item ``1, ..., n`` to its image, the entry at index
+    0 is ignored.  The permutation must map each option to another option of the
+    problem.  It is translated into an option permutation when calling
+    ``solve``, therefore options may be added after calling this function.
+  */
+  void add_item_symmetry( const std::vector<uint32_t>& item_permutation )
+  {
+    assert( item_permutation.size() == num_items + 1 );
+    abort_steps();
+    item_symmetries.push_back( item_permutation );
+    symmetries_dirty = true;
+  }
+
+  /*! \brief Number of solutions including all symmetric copies
+
+    If symmetries are declared, this returns the number of solutions found in
+    the last call to ``solve`` when each visited solution is accounted for with
+    the size of its orbit.  Otherwise, it equals the return value of ``solve``.
+  */
+  inline uint32_t symmetric_solutions() const
+  {
+    return num_symmetric_solutions;
+  }
+
+  /*! \brief Sets budgets for subsequent searches
+
+    If a budget is exhausted or the cancellation flag is set, ``solve`` returns
+    the number of solutions found so far and ``status`` tells why the search
+    ended.  The matrix is restored, such that the solver can be used again.
+  */
+  void set_limits( const search_limits& new_limits )
+  {
+    limits = new_limits;
+  }
+
+  /*! \brief Budgets for subsequent searches */
+  inline const search_limits& current_limits() const
+  {
+    return limits;
+  }
+
+  /*! \brief Calls a function every ``interval`` search nodes
+
+    The function is called with a ``search_progress`` object that describes the
+    current position in the search tree.  Passing an empty function disables
+    progress reporting, in which case there is no overhead in the search.
+  */
+  void set_progress( uint64_t interval, std::function<void( const search_progress& )> fn )
+  {
+    assert( interval != 0u );
+    progress_interval = interval;
+    progress_fn = std::move( fn );
+  }
+
+  /*! \brief Enables a cache of failed residual problems
+
+    With a non-zero capacity, ``solve`` records each subtree that has been
+    explored completely without finding a solution, keyed by the set of
+    covered items (which determines the residual problem), and skips subtrees
+    whose residual problem is in the cache.  This avoids re-exploring
+    unsatisfiable residual problems that are reached via different orders of
+    options.  At most ``capacity`` entries are stored, where the least recently
+    used one is evicted.  Since pruned subtrees may contain solutions that are
+    not canonical, failures are not recorded when symmetries are declared.
+    Recorded failures remain valid until options are added.  Enabling the
+    cache aborts a paused search.
+  */
+  void enable_failure_cache( std::size_t capacity )
+  {
+    abort_steps();
+    failures.set_capacity( capacity );
+  }
+
+  /*! \brief Lookup, hit, insertion, and eviction counters of the failure cache */
+  inline const cache_statistics& failure_cache_statistics() const
+  {
+    return failures.statistics();
+  }
+
+  /*! \brief Item selection function, e.g., to inspect learned weights */
+  inline const ItemSelectionFn& selection() const
+  {
+    return item_selection;
+  }
+
+  /*! \brief Reason why the last search returned */
+  inline solve_status status() const
+  {
+    return last_status;
+  }
+
+  /*! \brief Address and size in bytes of the ``items`` and ``nodes`` arrays
+
+    This can be used to check on which NUMA node the matrix resides.
+  */
+  inline std::array<std::pair<const void*, std::size_t>, 2> matrix_memory() const
+  {
+    return {{{items.data(), items.size() * sizeof( item_type )}, {nodes.data(), nodes.size() * sizeof( node_type )}}};
+  }
+
+  /*! \brief Number of options that have been added */
+  inline index_type num_options() const
+  {
+    return static_cast<index_type>( m );
+  }
+
+  /*! \brief Number of search nodes visited in the last search */
+  inline uint64_t nodes_visited() const
+  {
+    return num_nodes;
+  }
+
+  template<typename Fn = decltype( just_count )&>
   uint32_t solve( Fn&& fn = just_count )
   {
-    uint32_t l = 0, i = 0, solutions = 0;
-    std::vector<uint32_t> xs( items.size() );
+    abort_steps();
+    deadline = detail::deadline_after( limits.max_time );
+    run_node_limit = limits.max_nodes;
+    num_nodes = 0;
+    return solve_run( fn );
+  }
+
+  /*! \brief Runs a resumable search for a bounded amount of work
+
+    Explores at most ``max_nodes`` search nodes for at most ``max_time`` and
+    returns the number of solutions found in this call.  If the search is not
+    finished, ``status`` is ``budget_exhausted``, ``paused`` is true, and the
+    next call of ``solve_steps`` continues where this one stopped, such that
+    a host, e.g., an event loop, can do other work in between.  The time is
+    checked every ``check_interval`` nodes of the limits set with
+    ``set_limits``, whose cancellation flag is also respected; their budgets
+    are not used.  ``nodes_visited`` counts the nodes of all calls.  While the
+    search is paused, options must not be added; other searches, enabling the
+    failure cache, and declaring symmetries first abort the paused search,
+    which can also be done with ``abort_steps``.
+  */
+  template<typename Fn = decltype( just_count )&>
+  uint32_t solve_steps( uint64_t max_nodes, std::chrono::steady_clock::duration max_time = std::chrono::steady_clock::duration::max(), Fn&& fn = just_count )
+  {
+    if ( !paused )
+    {
+      num_nodes = 0;
+    }
+    deadline = detail::deadline_after( max_time );
+    run_node_limit = max_nodes;
+    return solve_run( fn, true );
+  }
+
+  /*! \brief True, if a search started with ``solve_steps`` can be continued */
+  inline bool is_paused() const
+  {
+    return paused;
+  }
+
+  /*! \brief Aborts a paused search and restores the matrix */
+  void abort_steps()
+  {
+    if ( paused )
+    {
+      unwind( paused_level, !symmetries.empty() );
+      paused = false;
+    }
+  }
+
+private:
+  /* If pause is true and the node or time budget is exhausted, the search is
+     not unwound, but its level is saved, such that the next call continues
+     where it stopped.  Returns the number of solutions found in this call. */
+  template<typename Fn>
+  uint32_t solve_run( Fn&& fn, bool pause = false )
+  {
+    uint32_t l = 0, solutions = 0;
+    index_type i = 0;
+
+    prepare_symmetries();
+    const auto break_symmetries = !symmetries.empty();
+    last_status = solve_status::complete;
+
+    const auto use_cache = failures.enabled();
+    const auto record_failures = use_cache && !break_symmetries;
+
+    if ( paused )
+    {
+      l = paused_level;
+      solutions = paused_solutions;
+      paused = false;
+    }
+    else
+    {
+      xs.resize( items.size() );
+      num_symmetric_solutions = 0;
+      if ( use_cache )
+      {
+        /* the key contains all covered items, such that failures recorded
+           below one prefix remain valid below other prefixes */
+        if ( prefix_key.size() == ( num_items + 64u ) / 64u )
+        {
+          covered_key = prefix_key;
+        }
+        else
+        {
+          covered_key.assign( ( num_items + 64u ) / 64u, 0u );
+        }
+        level_solutions.resize( items.size() );
+      }
+    }
+
+    /* solutions are counted from the start of a paused search */
+    const auto first_solution = solutions;
+
+    const auto node_limit = run_node_limit > std::numeric_limits<uint64_t>::max() - num_nodes ? std::numeric_limits<uint64_t>::max() : num_nodes + run_node_limit;
+    auto next_progress = progress_fn ? num_nodes + progress_interval : std::numeric_limits<uint64_t>::max();
+    auto next_check = std::min( {node_limit, num_nodes + limits.check_interval, next_progress - 1} );
 
     while ( true )
     {
+      if ( ++num_nodes > next_check )
+      {
+        if ( !check_limits( node_limit ) )
+        {
+          if ( pause && last_status == solve_status::budget_exhausted )
+          {
+            paused = true;
+            paused_level = l;
+            paused_solutions = solutions;
+            return solutions - first_solution;
+          }
+          unwind( l, break_symmetries );
+          return solutions - first_solution;
+        }
+        if ( num_nodes >= next_progress )
+        {
+          report_progress( l );
+          next_progress += progress_interval;
+        }
+        next_check = std::min( {node_limit, num_nodes + limits.check_interval, next_progress - 1} );
+      }
+
+      /* prune branches that cannot lead to a lexicographically smallest solution */
+      if ( break_symmetries && l != 0 && !is_leader_candidate() )
+      {
+        goto check_last;
+      }
+
+      /* skip residual problems that are known to have no solution */
+      if ( use_cache )
+      {
+        if ( l != 0 && failures.contains( covered_key ) )
+        {
+          goto check_last;
+        }
+        level_solutions[l] = solutions;
+      }
+
       /* all items have been chose */
       if ( items[0].rlink == 0 )
       {
+        if ( break_symmetries )
+        {
+          const auto stabilizer = leader_stabilizer();
+          if ( stabilizer == 0u )
+          {
+            goto check_last;
+          }
+          num_symmetric_solutions += ( symmetries.size() + 1 ) / stabilizer;
+        }
+        else
+        {
+          ++num_symmetric_solutions;
+        }
+
         ++solutions;
-        if ( !fn( xs.cbegin(), xs.cbegin() + l ) )
+        if ( !fn( xs.data(), xs.data() + l ) )
         {
-          return solutions;
+          last_status = solve_status::stopped;
+          unwind( l, break_symmetries );
+          return solutions - first_solution;
         }
         goto check_last;
       }
@@ -143,17 +580,35 @@ public:
       cover( i );
       xs[l] = nodes[i].dlink;
 
+      if ( xs[l] == i )
+      {
+        notify_dead_end( i, detail::has_dead_end<ItemSelectionFn>() );
+      }
+
       while ( xs[l] == i ) /* we tried all options for item i */
       {
         uncover( i );
 
+        if ( record_failures && l != 0 && solutions == level_solutions[l] )
+        {
+          failures.insert( covered_key );
+        }
+
       check_last:
         if ( l == 0 )
-          return solutions;
+          return solutions - first_solution;
 
         /* uncovers items in option */
         --l;
         uncover_option( xs[l] );
+        if ( break_symmetries )
+        {
+          mark_option( xs[l], false );
+        }
+        if ( use_cache )
+        {
+          toggle_items( covered_key, xs[l] );
+        }
 
         /* next i */
         i = nodes[xs[l]].top;
@@ -162,121 +617,491 @@ public:
 
       /* cover items in option */
       cover_option( xs[l] );
+      if ( break_symmetries )
+      {
+        mark_option( xs[l], true );
+      }
+      if ( use_cache )
+      {
+        toggle_items( covered_key, xs[l] );
+      }
       ++l;
     }
 
     /* we'll never reach here */
-    return solutions;
+    return solutions - first_solution;
   }
 
-  inline uint32_t option_index( uint32_t i )
+public:
+  /*! \brief Solves with randomized restarts
+
+    Runs ``solve`` repeatedly, where run ``r`` is aborted after ``base_nodes``
+    times the ``r``-th element of the Luby sequence (1, 1, 2, 1, 1, 2, 4, ...)
+    search nodes.  Before each run, the options of each item are shuffled.
+    Restarts stop as soon as the solution callback returns false, a run explores
+    the complete search space, or the budgets set with ``set_limits`` for the
+    whole sequence of runs are exhausted.  This is meant for first-solution
+    queries, e.g., with ``stop_after_first``, in combination with a randomized
+    item selection such as ``random_mrv_heuristic``; if the callback keeps
+    returning true, solutions may be visited again in later runs.
+  */
+  template<typename Fn = decltype( just_count )&>
+  uint32_t solve_with_restarts( Fn&& fn = just_count, uint64_t base_nodes = 1024u, uint64_t seed = 0u )
   {
-    auto q = i - 1;
-    while ( nodes[q].top > 0 )
+    abort_steps();
+    std::mt19937_64 rng( seed );
+    deadline = detail::deadline_after( limits.max_time );
+    num_nodes = 0;
+
+    uint32_t solutions = 0u;
+    for ( auto r = 1u;; ++r )
     {
-      --q;
+      shuffle_options( rng );
+      run_node_limit = std::min( base_nodes * detail::luby( r ), limits.max_nodes - num_nodes );
+      solutions += solve_run( fn );
+
+      if ( last_status != solve_status::budget_exhausted ||
+           num_nodes >= limits.max_nodes ||
+           std::chrono::steady_clock::now() >= deadline )
+      {
+        return solutions;
+      }
     }
-    return -nodes[q].top;
   }
 
-#if 0
-  /* debug */
-public:
-  void print_contents( std::ostream& os = std::cout )
-  {
-    /* seperation rule */
-    std::string rule( 5 * items.size() + 9, '-' );
+  /*! \brief Shuffles the order of options in each item's list
 
-    /* items */
-    os << rule << std::endl
-       << "       i:" << ( ranges::view::ints( size_t( 0 ), items.size() ) | detail::pad() | ranges::action::join ) << std::endl
-       << "llink(i):" << ( items | detail::pad( []( auto i ) { return i.llink; } ) | ranges::action::join ) << std::endl
-       << "rlink(i):" << ( items | detail::pad( []( auto i ) { return i.rlink; } ) | ranges::action::join ) << std::endl
-       << rule << std::endl;
+    This changes the order in which ``solve`` tries options when branching on an
+    item.
+  */
+  template<typename Rng>
+  void shuffle_options( Rng& rng )
+  {
+    abort_steps();
+    std::vector<index_type> list;
+    for ( auto i = 1u; i <= num_items; ++i )
+    {
+      list.clear();
+      for ( auto x = nodes[i].dlink; x != i; x = nodes[x].dlink )
+      {
+        list.push_back( x );
+      }
+      std::shuffle( list.begin(), list.end(), rng );
 
-    /* nodes */
-    const auto indexes = ranges::view::ints( size_t( 0 ), nodes.size() ) |
-                         detail::pad() |
-                         detail::split_and_prefix( items.size(), "       x:" );
+      index_type prev = i;
+      for ( auto x : list )
+      {
+        nodes[prev].dlink = x;
+        nodes[x].ulink = prev;
+        prev = x;
+      }
+      nodes[prev].dlink = i;
+      nodes[i].ulink = prev;
+    }
+  }
 
-    const auto tops = nodes |
-                      detail::pad( []( auto n ) { return n.top; } ) |
-                      detail::split_and_prefix( items.size(), "  top(x):" );
+  /*! \brief Finds a solution of minimum cost
 
-    const auto ulinks = nodes |
-                        detail::pad( []( auto n ) { return n.ulink; } ) |
-                        detail::split_and_prefix( items.size(), "ulink(x):" );
+    Branch and bound search in the spirit of Knuth's DLX6: the options of each
+    item are tried in order of increasing cost, and a branch is pruned if its
+    cost plus a lower bound for the remaining items is not smaller than the
+    cost of the best solution found so far.  The lower bound sums up, for each
+    remaining primary item, the smallest share of an active option's cost,
+    where the cost of an option is shared evenly among its primary items.
 
-    const auto dlinks = nodes |
-                        detail::pad( []( auto n ) { return n.dlink; } ) |
-                        detail::split_and_prefix( items.size(), "dlink(x):" );
+    The callback is called for each solution that improves the best cost, i.e.,
+    the last call receives an optimum solution.  Returns the minimum cost, or
+    infinity if there is no solution.  Note that this reorders the options in
+    each item's list by cost.
+  */
+  template<typename Fn = decltype( just_count )&>
+  double solve_min_cost( Fn&& fn = just_count )
+  {
+    abort_steps();
+    detail::incumbent_search<Fn> search{fn};
 
-    os << ( ranges::view::zip_with( [&rule]( const auto& l1, const auto& l2, const auto& l3, const auto& l4 ) { return l1 + l2 + l3 + l4 + rule + "\n"; },
-                                    indexes, tops, ulinks, dlinks ) |
-            ranges::action::join )
-       << std::endl;
+    prepare_costs();
+    xs.resize( items.size() );
+    branch_and_bound( 0u, 0.0, search );
+    return search.best;
   }
-#endif
 
-private:
-  void initialize_items()
+  /*! \brief Finds the k cheapest solutions
+
+    Uses the branch and bound search of ``solve_min_cost``, but keeps a bounded
+    max-heap of the ``k`` cheapest solutions found so far, and prunes a branch
+    if its lower bound is not smaller than the cost of the k-th cheapest one.
+    Afterwards, the callback is called for the solutions in order of increasing
+    cost (ties in arbitrary order); its return value is ignored.  Returns the
+    number of solutions found, which is ``k`` unless there are fewer solutions.
+  */
+  template<typename Fn>
+  uint32_t solve_top_k( uint32_t k, Fn&& fn )
   {
-    /* initialize linked list of top items */
-    for ( auto i = 1u; i <= num_items; ++i )
+    abort_steps();
+    if ( k == 0u )
     {
-      items[i].index = i;
-      items[i].llink = i - 1;
-      items[i - 1].rlink = i;
-
-      nodes[i].len = 0;
-      nodes[i].ulink = nodes[i].dlink = i;
+      return 0u;
     }
 
-    items[0].llink = primary_items;
-    items[primary_items].rlink = 0;
-    if ( secondary_items != 0 )
+    detail::top_k_search<index_type> search( k );
+
+    prepare_costs();
+    xs.resize( items.size() );
+    branch_and_bound( 0u, 0.0, search );
+
+    std::sort_heap( search.heap.begin(), search.heap.end(), detail::top_k_search<index_type>::less_cost );
+    for ( const auto& entry : search.heap )
     {
-      items[primary_items + 1].llink = num_items;
-      items[num_items].rlink = primary_items + 1;
+      fn( entry.second.data(), entry.second.data() + entry.second.size() );
     }
-
-    /* spacer */
-    nodes[num_items + 1].top = 0;
+    return static_cast<uint32_t>( search.heap.size() );
   }
 
-  inline void cover( uint32_t i )
+  /*! \brief Draws solutions uniformly at random
+
+    The residual problem after choosing some options only depends on the set
+    of covered items.  The number of solutions of each residual problem in the
+    search tree is computed once and memoized, keyed by this set, for at most
+    ``max_memo_entries`` residual problems (further ones are recomputed on
+    demand).  A sample is drawn by descending from the root and choosing each
+    option with probability proportional to the number of solutions of its
+    subtree.  Returns the option indices of ``num_samples`` samples, or no
+    samples, if there is no solution.
+  */
+  template<typename Rng>
+  std::vector<std::vector<uint32_t>> sample_uniform( uint32_t num_samples, Rng& rng, std::size_t max_memo_entries = std::size_t( 1 ) << 20 )
   {
-    auto p = nodes[i].dlink;
-    while ( p != i )
+    abort_steps();
+    std::vector<std::vector<uint32_t>> samples;
+
+    prepare_sampling( max_memo_entries );
+    if ( count_memoized() == 0u )
     {
-      hide( p );
-      p = nodes[p].dlink;
+      return samples;
     }
 
-    /* dancing links */
-    const auto l = items[i].llink;
-    const auto r = items[i].rlink;
-    items[l].rlink = r;
-    items[r].llink = l;
-  }
-
-  inline void uncover( uint32_t i )
-  {
-    const auto l = items[i].llink;
-    const auto r = items[i].rlink;
-    items[l].rlink = i;
-    items[r].llink = i;
-    auto p = nodes[i].ulink;
-    while ( p != i )
+    std::vector<uint32_t> sample;
+    for ( auto k = 0u; k < num_samples; ++k )
     {
-      unhide( p );
-      p = nodes[p].ulink;
+      sample.clear();
+      descend_uniform( rng, sample );
+      samples.push_back( sample );
     }
+
+    sample_memo.clear();
+    return samples;
   }
 
-  inline void hide( uint32_t i )
+  /*! \brief Random probe with importance weight
+
+    The options of a sample probe and its weight.  The weight is the product
+    of the number of options at each branching item, and 0 if the probe reached
+    a dead end.
+  */
+  struct weighted_sample
   {
-    auto q = i + 1;
+    std::vector<uint32_t> options;
+    double weight;
+  };
+
+  /*! \brief Draws random probes with importance weights
+
+    If exact counting is infeasible, this follows Knuth's estimation procedure
+    (TAOCP, Section 7.2.2): each probe descends from the root choosing an option
+    of the branching item uniformly at random.  The mean weight of the probes is
+    an unbiased estimate of the number of solutions, and weighting the
+    successful probes by their weights (self-normalized importance sampling)
+    gives estimates for the uniform distribution over solutions.
+  */
+  template<typename Rng>
+  std::vector<weighted_sample> sample_weighted( uint32_t num_probes, Rng& rng )
+  {
+    abort_steps();
+    std::vector<weighted_sample> probes;
+    std::vector<index_type> path;
+
+    for ( auto k = 0u; k < num_probes; ++k )
+    {
+      weighted_sample probe{{}, 1.0};
+      path.clear();
+
+      while ( items[0].rlink != 0 )
+      {
+        const index_type i = item_selection( items, nodes );
+        if ( nodes[i].len == 0 )
+        {
+          probe.weight = 0.0;
+          break;
+        }
+
+        probe.weight *= nodes[i].len;
+        auto x = nodes[i].dlink;
+        for ( auto r = std::uniform_int_distribution<uint64_t>( 0u, nodes[i].len - 1 )( rng ); r != 0u; --r )
+        {
+          x = nodes[x].dlink;
+        }
+
+        cover( i );
+        cover_option( x );
+        path.push_back( x );
+        probe.options.push_back( option_index( x ) );
+      }
+
+      for ( auto it = path.rbegin(); it != path.rend(); ++it )
+      {
+        uncover_option( *it );
+        uncover( nodes[*it].top );
+      }
+      probes.push_back( probe );
+    }
+
+    return probes;
+  }
+
+  /*! \brief Counts solutions by decomposing the residual problem
+
+    Whenever the remaining active items split into components that share no
+    active option, each component is counted independently and the counts are
+    multiplied.  This avoids exploring the Cartesian product of the components'
+    solutions and is exponentially faster on decomposable instances.  No
+    solutions are visited, and declared symmetries are ignored.
+
+    Since finding components scans all active options, a check that finds a
+    single component is not repeated at the next 1, 3, 7, ... levels below
+    it, which keeps the overhead small on instances that do not decompose.
+  */
+  uint64_t solve_decomposed()
+  {
+    abort_steps();
+    return count_residual();
+  }
+
+  /*! \brief Solves the residual problem after choosing some options
+
+    The options, given by their indices, are chosen before the search starts,
+    e.g., a prefix returned by ``split``, and the matrix is restored
+    afterwards.  The options must not share primary items.  The callback only
+    receives the options of the residual problem, i.e., a complete solution
+    consists of these and the given options.  Budgets apply as in ``solve``,
+    and symmetries must not be declared.
+  */
+  template<typename Fn = decltype( just_count )&>
+  uint32_t solve_prefix( const std::vector<index_type>& prefix, Fn&& fn = just_count )
+  {
+    abort_steps();
+    assert( option_symmetries.empty() && item_symmetries.empty() );
+
+    cover_options( prefix );
+    const auto solutions = solve( fn );
+    uncover_options( prefix );
+
+    return solutions;
+  }
+
+  /*! \brief Solves a problem instance with given options
+
+    This is meant for problems, e.g., sudoku puzzles, whose matrix is the same
+    for all instances, but which differ in the options that are given.  The
+    matrix is built once, and for each instance the given options are chosen
+    before the search and restored afterwards, which is much faster than
+    building a new solver.  Unlike ``solve_prefix``, the given options may be
+    incompatible, in which case there is no solution.  The callback only
+    receives the options that complete the given ones.
+  */
+  template<typename Fn = decltype( just_count )&>
+  uint32_t solve_given( const std::vector<index_type>& givens, Fn&& fn = just_count )
+  {
+    if ( !givens_compatible( givens ) )
+    {
+      num_nodes = 0;
+      last_status = solve_status::complete;
+      return 0u;
+    }
+    return solve_prefix( givens, fn );
+  }
+
+  /*! \brief Checks whether an instance with given options has a unique solution
+
+    Stops the search after two solutions.  If ``solution`` is not null, it
+    receives the option indices of the first solution found, including the
+    given ones.  If a budget is set, ``status`` tells whether the search
+    completed.
+  */
+  uniqueness check_uniqueness( const std::vector<index_type>& givens, std::vector<index_type>* solution = nullptr )
+  {
+    uint32_t found = 0u;
+    solve_given( givens, [&]( auto begin, auto end ) {
+      if ( solution && found == 0u )
+      {
+        solution->assign( givens.begin(), givens.end() );
+        for ( auto it = begin; it != end; ++it )
+        {
+          solution->push_back( option_index( *it ) );
+        }
+      }
+      return ++found < 2u;
+    } );
+    return found == 0u ? uniqueness::none : found == 1u ? uniqueness::unique : uniqueness::multiple;
+  }
+
+  /*! \brief Fingerprint of the problem for caching results
+
+    The fingerprint depends on the numbers of primary and secondary items and
+    on the options as sets of items, but not on the order of the options or of
+    the items within an option.  If ``item_invariant`` is true, it is also
+    invariant under renumbering items, at the price of possibly equal
+    fingerprints for some non-isomorphic problems, see
+    ``detail::instance_fingerprint``.  Symmetries and costs are not taken into
+    account.
+  */
+  uint64_t fingerprint( bool item_invariant = false, uint32_t rounds = 3u ) const
+  {
+    return detail::instance_fingerprint( primary_items, secondary_items, option_sets(), item_invariant, rounds );
+  }
+
+  /*! \brief Canonical form of the problem
+
+    Two problems have the same canonical form if and only if they have the
+    same numbers of primary and secondary items and the same options as sets
+    of items.  Unlike the fingerprint, it can be used to tell problems apart
+    reliably, see ``detail::canonical_form``.
+  */
+  std::vector<uint32_t> canonical_form() const
+  {
+    return detail::canonical_form( primary_items, secondary_items, option_sets() );
+  }
+
+  /*! \brief Splits the search tree below a prefix into subtrees
+
+    Returns all prefixes that extend ``prefix`` by ``depth`` options, using the
+    item selection function to branch as ``solve`` does.  Prefixes that cover
+    all primary items with fewer options are returned as they are, and
+    branches that end in a dead end before are omitted.  Hence, the solutions
+    below ``prefix`` are partitioned by the solutions below the returned
+    prefixes, which can be solved independently with ``solve_prefix``.
+  */
+  std::vector<std::vector<index_type>> split( const std::vector<index_type>& prefix, uint32_t depth )
+  {
+    abort_steps();
+    std::vector<std::vector<index_type>> prefixes;
+    auto current = prefix;
+
+    cover_options( prefix );
+    split_run( depth, current, prefixes );
+    uncover_options( prefix );
+
+    return prefixes;
+  }
+
+  inline index_type option_index( index_type i )
+  {
+    auto q = i - 1;
+    while ( nodes[q].top > 0 )
+    {
+      --q;
+    }
+    return -nodes[q].top;
+  }
+
+#if 0
+  /* debug */
+public:
+  void print_contents( std::ostream& os = std::cout )
+  {
+    /* seperation rule */
+    std::string rule( 5 * items.size() + 9, '-' );
+
+    /* items */
+    os << rule << std::endl
+       << "       i:" << ( ranges::view::ints( size_t( 0 ), items.size() ) | detail::pad() | ranges::action::join ) << std::endl
+       << "llink(i):" << ( items | detail::pad( []( auto i ) { return i.llink; } ) | ranges::action::join ) << std::endl
+       << "rlink(i):" << ( items | detail::pad( []( auto i ) { return i.rlink; } ) | ranges::action::join ) << std::endl
+       << rule << std::endl;
+
+    /* nodes */
+    const auto indexes = ranges::view::ints( size_t( 0 ), nodes.size() ) |
+                         detail::pad() |
+                         detail::split_and_prefix( items.size(), "       x:" );
+
+    const auto tops = nodes |
+                      detail::pad( []( auto n ) { return n.top; } ) |
+                      detail::split_and_prefix( items.size(), "  top(x):" );
+
+    const auto ulinks = nodes |
+                        detail::pad( []( auto n ) { return n.ulink; } ) |
+                        detail::split_and_prefix( items.size(), "ulink(x):" );
+
+    const auto dlinks = nodes |
+                        detail::pad( []( auto n ) { return n.dlink; } ) |
+                        detail::split_and_prefix( items.size(), "dlink(x):" );
+
+    os << ( ranges::view::zip_with( [&rule]( const auto& l1, const auto& l2, const auto& l3, const auto& l4 ) { return l1 + l2 + l3 + l4 + rule + "\n"; },
+                                    indexes, tops, ulinks, dlinks ) |
+            ranges::action::join )
+       << std::endl;
+  }
+#endif
+
+private:
+  void initialize_items()
+  {
+    /* initialize linked list of top items */
+    for ( auto i = 1u; i <= num_items; ++i )
+    {
+      items[i].index = i;
+      items[i].llink = i - 1;
+      items[i - 1].rlink = i;
+
+      nodes[i].len = 0;
+      nodes[i].ulink = nodes[i].dlink = i;
+    }
+
+    items[0].llink = primary_items;
+    items[primary_items].rlink = 0;
+    if ( secondary_items != 0 )
+    {
+      items[primary_items + 1].llink = num_items;
+      items[num_items].rlink = primary_items + 1;
+    }
+
+    /* spacer */
+    nodes[num_items + 1].top = 0;
+  }
+
+  inline void cover( index_type i )
+  {
+    auto p = nodes[i].dlink;
+    while ( p != i )
+    {
+      hide( p );
+      p = nodes[p].dlink;
+    }
+
+    /* dancing links */
+    const auto l = items[i].llink;
+    const auto r = items[i].rlink;
+    items[l].rlink = r;
+    items[r].llink = l;
+  }
+
+  inline void uncover( index_type i )
+  {
+    const auto l = items[i].llink;
+    const auto r = items[i].rlink;
+    items[l].rlink = i;
+    items[r].llink = i;
+    auto p = nodes[i].ulink;
+    while ( p != i )
+    {
+      unhide( p );
+      p = nodes[p].ulink;
+    }
+  }
+
+  inline void hide( index_type i )
+  {
+    auto q = i + 1;
 
     while ( q != i )
     {
@@ -297,7 +1122,7 @@ private:
     }
   }
 
-  inline void unhide( uint32_t i )
+  inline void unhide( index_type i )
   {
     auto q = i - 1;
 
@@ -320,7 +1145,7 @@ private:
     }
   }
 
-  inline void cover_option( uint32_t i )
+  inline void cover_option( index_type i )
   {
     auto p = i + 1;
     while ( p != i )
@@ -338,7 +1163,7 @@ private:
     }
   }
 
-  inline void uncover_option( uint32_t i )
+  inline void uncover_option( index_type i )
   {
     auto p = i - 1;
     while ( p != i )
@@ -356,15 +1181,777 @@ private:
     }
   }
 
+  inline void notify_dead_end( index_type i, std::true_type )
+  {
+    item_selection.dead_end( i );
+  }
+
+  inline void notify_dead_end( index_type, std::false_type ) {}
+
+  /* false, if search must stop; sets last_status accordingly */
+  bool check_limits( uint64_t node_limit )
+  {
+    if ( num_nodes > node_limit )
+    {
+      --num_nodes; /* this node is not visited */
+      last_status = solve_status::budget_exhausted;
+      return false;
+    }
+    if ( limits.cancel && limits.cancel->load( std::memory_order_relaxed ) )
+    {
+      last_status = solve_status::cancelled;
+      return false;
+    }
+    if ( deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= deadline )
+    {
+      --num_nodes; /* this node is not visited */
+      last_status = solve_status::budget_exhausted;
+      return false;
+    }
+    return true;
+  }
+
+  void report_progress( uint32_t l )
+  {
+    progress.nodes = num_nodes;
+    progress.level = l;
+    progress.positions.resize( l );
+    progress.lengths.resize( l );
+    for ( auto k = 0u; k < l; ++k )
+    {
+      const auto i = nodes[xs[k]].top;
+      auto position = 0u;
+      for ( auto x = nodes[i].dlink; x != xs[k]; x = nodes[x].dlink )
+      {
+        ++position;
+      }
+      progress.positions[k] = position;
+      progress.lengths[k] = nodes[i].len;
+    }
+    progress.estimate = detail::estimate_progress( progress.positions, progress.lengths, l );
+    progress_fn( progress );
+  }
+
+  /* restores the state before search after solve returns early */
+  void unwind( uint32_t l, bool break_symmetries )
+  {
+    while ( l != 0 )
+    {
+      --l;
+      uncover_option( xs[l] );
+      if ( break_symmetries )
+      {
+        mark_option( xs[l], false );
+      }
+      uncover( nodes[xs[l]].top );
+    }
+  }
+
+  /* branch and bound */
+  void prepare_costs()
+  {
+    option_costs.resize( m, 0.0 );
+    node_cost.assign( nodes.size(), 0.0 );
+    node_share.assign( nodes.size(), 0.0 );
+
+    /* cost and share of cost per primary item in each node */
+    std::size_t o = 0u;
+    for ( index_type p = num_items + 2; p < nodes.size(); ++p )
+    {
+      const auto first = p;
+      auto primary = 0u;
+      for ( ; nodes[p].top > 0; ++p )
+      {
+        primary += static_cast<uint32_t>( nodes[p].top ) <= primary_items ? 1u : 0u;
+      }
+      for ( auto q = first; q < p; ++q )
+      {
+        node_cost[q] = option_costs[o];
+        node_share[q] = primary == 0u ? 0.0 : option_costs[o] / primary;
+      }
+      ++o;
+    }
+
+    /* sort options of each item by cost */
+    std::vector<index_type> list;
+    for ( auto i = 1u; i <= num_items; ++i )
+    {
+      list.clear();
+      for ( auto x = nodes[i].dlink; x != i; x = nodes[x].dlink )
+      {
+        list.push_back( x );
+      }
+      std::stable_sort( list.begin(), list.end(), [this]( auto a, auto b ) { return node_cost[a] < node_cost[b]; } );
+
+      index_type prev = i;
+      for ( auto x : list )
+      {
+        nodes[prev].dlink = x;
+        nodes[x].ulink = prev;
+        prev = x;
+      }
+      nodes[prev].dlink = i;
+      nodes[i].ulink = prev;
+    }
+  }
+
+  /* sum of the cheapest shares of all active primary items, infinity at a dead end */
+  double cost_lower_bound() const
+  {
+    auto bound = 0.0;
+    for ( auto p = items[0].rlink; p != 0; p = items[p].rlink )
+    {
+      auto min = std::numeric_limits<double>::infinity();
+      for ( auto x = nodes[p].dlink; x != p; x = nodes[x].dlink )
+      {
+        min = std::min( min, node_share[x] );
+      }
+      bound += min;
+    }
+    return bound;
+  }
+
+  /* search has threshold() and solution( cost, begin, end ); returns false, if search should stop */
+  template<typename Search>
+  bool branch_and_bound( uint32_t l, double cost, Search& search )
+  {
+    if ( items[0].rlink == 0 )
+    {
+      return search.solution( cost, xs.data(), xs.data() + l );
+    }
+
+    if ( cost + cost_lower_bound() >= search.threshold() )
+    {
+      return true;
+    }
+
+    const index_type i = item_selection( items, nodes );
+    cover( i );
+    for ( auto x = nodes[i].dlink; x != i; x = nodes[x].dlink )
+    {
+      /* options are sorted by cost, all remaining ones are at least as expensive */
+      const auto next_cost = cost + node_cost[x];
+      if ( next_cost >= search.threshold() )
+      {
+        break;
+      }
+
+      xs[l] = x;
+      cover_option( x );
+      const auto proceed = branch_and_bound( l + 1u, next_cost, search );
+      uncover_option( x );
+
+      if ( !proceed )
+      {
+        uncover( i );
+        return false;
+      }
+    }
+    uncover( i );
+    return true;
+  }
+
+  /* uniform sampling */
+  void prepare_sampling( std::size_t max_memo_entries )
+  {
+    sample_memo.clear();
+    sample_memo_limit = max_memo_entries;
+    sample_key.assign( ( num_items + 64u ) / 64u, 0u );
+  }
+
+  /* toggles the items of the option of node x in a bitset */
+  inline void toggle_items( key_type& key, index_type x ) const
+  {
+    auto q = x;
+    while ( nodes[q - 1].top > 0 )
+    {
+      --q;
+    }
+    for ( ; nodes[q].top > 0; ++q )
+    {
+      const auto j = static_cast<uint32_t>( nodes[q].top );
+      key[j >> 6] ^= uint64_t( 1 ) << ( j & 63 );
+    }
+  }
+
+  uint64_t count_memoized()
+  {
+    if ( items[0].rlink == 0 )
+    {
+      return 1u;
+    }
+
+    const auto it = sample_memo.find( sample_key );
+    if ( it != sample_memo.end() )
+    {
+      return it->second;
+    }
+
+    const index_type i = item_selection( items, nodes );
+    uint64_t total = 0u;
+
+    cover( i );
+    for ( auto x = nodes[i].dlink; x != i; x = nodes[x].dlink )
+    {
+      cover_option( x );
+      toggle_items( sample_key, x );
+      total += count_memoized();
+      toggle_items( sample_key, x );
+      uncover_option( x );
+    }
+    uncover( i );
+
+    if ( sample_memo.size() < sample_memo_limit )
+    {
+      sample_memo.emplace( sample_key, total );
+    }
+    return total;
+  }
+
+  /* draws one uniform sample from a residual problem with at least one solution */
+  template<typename Rng>
+  void descend_uniform( Rng& rng, std::vector<uint32_t>& sample )
+  {
+    if ( items[0].rlink == 0 )
+    {
+      return;
+    }
+
+    const index_type i = item_selection( items, nodes );
+    cover( i );
+
+    /* pick the r-th solution among all solutions of the subtrees */
+    auto r = std::uniform_int_distribution<uint64_t>( 0u, count_children( i ) - 1u )( rng );
+    for ( auto x = nodes[i].dlink; x != i; x = nodes[x].dlink )
+    {
+      cover_option( x );
+      toggle_items( sample_key, x );
+      const auto count = count_memoized();
+      if ( r < count )
+      {
+        sample.push_back( option_index( x ) );
+        descend_uniform( rng, sample );
+        toggle_items( sample_key, x );
+        uncover_option( x );
+        break;
+      }
+      r -= count;
+      toggle_items( sample_key, x );
+      uncover_option( x );
+    }
+
+    uncover( i );
+  }
+
+  /* number of solutions when branching on covered item i */
+  uint64_t count_children( index_type i )
+  {
+    uint64_t total = 0u;
+    for ( auto x = nodes[i].dlink; x != i; x = nodes[x].dlink )
+    {
+      cover_option( x );
+      toggle_items( sample_key, x );
+      total += count_memoized();
+      toggle_items( sample_key, x );
+      uncover_option( x );
+    }
+    return total;
+  }
+
+  /* component decomposition; a check that finds a single component is not
+     repeated for the next wait levels below it, and the wait grows from 1 to
+     3, 7, ... as long as checks find no split */
+  uint64_t count_residual( uint32_t wait = 0u, uint32_t backoff = 0u )
+  {
+    if ( items[0].rlink == 0 )
+    {
+      return 1u;
+    }
+    if ( wait != 0u )
+    {
+      return count_branch( wait - 1u, backoff );
+    }
+
+    const auto base = component_stack.size();
+    const auto num_components = active_components();
+    if ( num_components == 1u )
+    {
+      component_stack.resize( base );
+      backoff = 2u * backoff + 1u;
+      return count_branch( backoff, backoff );
+    }
+
+    /* the stack holds the active primary items, then the items grouped by
+       component, then the component boundaries; the search restricts itself
+       to one component at a time */
+    const auto num_active = ( component_stack.size() - base - num_components - 1u ) / 2u;
+    const auto grouped = base + num_active;
+    const auto bounds = grouped + num_active;
+
+    uint64_t product = 1u;
+    for ( auto c = 0u; c < num_components && product != 0u; ++c )
+    {
+      link_primary_items( grouped + component_stack[bounds + c], grouped + component_stack[bounds + c + 1u] );
+      product *= count_branch( 0u, 0u );
+    }
+
+    link_primary_items( base, base + num_active );
+    component_stack.resize( base );
+    return product;
+  }
+
+  uint64_t count_branch( uint32_t wait, uint32_t backoff )
+  {
+    const auto i = item_selection( items, nodes );
+    uint64_t total = 0u;
+
+    cover( i );
+    for ( auto x = nodes[i].dlink; x != i; x = nodes[x].dlink )
+    {
+      cover_option( x );
+      total += count_residual( wait, backoff );
+      uncover_option( x );
+    }
+    uncover( i );
+
+    return total;
+  }
+
+  /* groups active primary items which are connected via active options,
+     pushes them onto the component stack (see count_residual), and returns
+     the number of components */
+  uint32_t active_components()
+  {
+    component_parent.resize( items.size() );
+    component_index.resize( items.size() );
+    for ( auto p = items[0].rlink; p != 0; p = items[p].rlink )
+    {
+      component_parent[p] = p;
+      for ( auto x = nodes[p].dlink; x != p; x = nodes[x].dlink )
+      {
+        /* first node of option */
+        auto q = x;
+        while ( nodes[q - 1].top > 0 )
+        {
+          --q;
+        }
+        for ( ; nodes[q].top > 0; ++q )
+        {
+          const auto j = static_cast<uint32_t>( nodes[q].top );
+          if ( j > primary_items && component_parent[j] == 0u )
+          {
+            component_parent[j] = j; /* first visit of a secondary item */
+            touched_secondary.push_back( j );
+          }
+          if ( j != p && ( j > primary_items || component_parent[j] != 0u ) )
+          {
+            unite_components( p, j );
+          }
+        }
+      }
+    }
+
+    /* number components by their roots (1-based) and count their sizes */
+    const auto base = component_stack.size();
+    uint32_t num_components = 0u;
+    for ( auto p = items[0].rlink; p != 0; p = items[p].rlink )
+    {
+      const auto root = find_component( p );
+      if ( component_index[root] == 0u )
+      {
+        component_index[root] = ++num_components;
+      }
+      component_stack.push_back( p );
+    }
+    const auto num_active = component_stack.size() - base;
+
+    if ( num_components > 1u )
+    {
+      /* counting sort of the active items by component */
+      const auto grouped = base + num_active;
+      const auto bounds = grouped + num_active;
+      component_stack.resize( bounds + num_components + 1u, 0u );
+      for ( auto k = base; k < grouped; ++k )
+      {
+        ++component_stack[bounds + component_index[find_component( component_stack[k] )]];
+      }
+      for ( auto c = 1u; c <= num_components; ++c )
+      {
+        component_stack[bounds + c] += component_stack[bounds + c - 1u];
+      }
+      for ( auto k = base; k < grouped; ++k )
+      {
+        const auto p = component_stack[k];
+        component_stack[grouped + component_stack[bounds + component_index[find_component( p )] - 1u]++] = p;
+      }
+      /* the placement shifted all boundaries by one component */
+      for ( auto c = num_components; c > 0u; --c )
+      {
+        component_stack[bounds + c] = component_stack[bounds + c - 1u];
+      }
+      component_stack[bounds] = 0u;
+    }
+
+    /* reset union-find for next call */
+    for ( auto k = base; k < base + num_active; ++k )
+    {
+      const auto p = component_stack[k];
+      component_index[find_component( p )] = 0u;
+    }
+    for ( auto k = base; k < base + num_active; ++k )
+    {
+      component_parent[component_stack[k]] = 0u;
+    }
+    for ( auto j : touched_secondary )
+    {
+      component_parent[j] = 0u;
+    }
+    touched_secondary.clear();
+
+    return num_components;
+  }
+
+  inline uint32_t find_component( uint32_t j )
+  {
+    while ( component_parent[j] != j )
+    {
+      j = component_parent[j] = component_parent[component_parent[j]];
+    }
+    return j;
+  }
+
+  inline void unite_components( uint32_t a, uint32_t b )
+  {
+    a = find_component( a );
+    b = find_component( b );
+    if ( a != b )
+    {
+      component_parent[std::max( a, b )] = std::min( a, b );
+    }
+  }
+
+  /* links the primary items at positions [first, last) of the component stack */
+  inline void link_primary_items( std::size_t first, std::size_t last )
+  {
+    auto prev = 0u;
+    for ( ; first != last; ++first )
+    {
+      const auto j = component_stack[first];
+      items[prev].rlink = j;
+      items[j].llink = prev;
+      prev = j;
+    }
+    items[prev].rlink = 0u;
+    items[0].llink = prev;
+  }
+
+  /* items of all options in insertion order */
+  std::vector<std::vector<uint32_t>> option_sets() const
+  {
+    std::vector<std::vector<uint32_t>> options;
+    for ( index_type p = num_items + 2; p < nodes.size(); ++p )
+    {
+      options.emplace_back();
+      for ( ; nodes[p].top > 0; ++p )
+      {
+        options.back().push_back( nodes[p].top );
+      }
+    }
+    return options;
+  }
+
+  /* symmetry breaking */
+  /* first node of each option */
+  void prepare_option_begin()
+  {
+    if ( option_begin.size() == static_cast<std::size_t>( m ) )
+    {
+      return;
+    }
+
+    option_begin.clear();
+    for ( index_type p = num_items + 2; p < nodes.size(); ++p )
+    {
+      if ( nodes[p - 1].top <= 0 )
+      {
+        option_begin.push_back( p );
+      }
+    }
+    option_begin.resize( m );
+  }
+
+  /* true, if no two options share an item */
+  bool givens_compatible( const std::vector<index_type>& givens )
+  {
+    prepare_option_begin();
+    item_given.assign( num_items + 1, false );
+    for ( auto o : givens )
+    {
+      if ( o >= static_cast<index_type>( m ) )
+      {
+        return false;
+      }
+      for ( auto p = option_begin[o]; nodes[p].top > 0; ++p )
+      {
+        if ( item_given[nodes[p].top] )
+        {
+          return false;
+        }
+        item_given[nodes[p].top] = true;
+      }
+    }
+    return true;
+  }
+
+  /* covers all items of the given options, which must be compatible */
+  void cover_options( const std::vector<index_type>& options )
+  {
+    prepare_option_begin();
+    prefix_key.resize( ( num_items + 64u ) / 64u, 0u );
+    for ( auto o : options )
+    {
+      toggle_items( prefix_key, option_begin[o] );
+      for ( auto p = option_begin[o]; nodes[p].top > 0; ++p )
+      {
+        assert( nodes[p].top > static_cast<signed_index_type>( primary_items ) || items[items[nodes[p].top].llink].rlink == static_cast<index_type>( nodes[p].top ) );
+        cover( nodes[p].top );
+      }
+    }
+  }
+
+  void uncover_options( const std::vector<index_type>& options )
+  {
+    for ( auto it = options.rbegin(); it != options.rend(); ++it )
+    {
+      toggle_items( prefix_key, option_begin[*it] );
+      auto p = option_begin[*it];
+      while ( nodes[p].top > 0 )
+      {
+        ++p;
+      }
+      while ( p != option_begin[*it] )
+      {
+        uncover( nodes[--p].top );
+      }
+    }
+  }
+
+  void split_run( uint32_t depth, std::vector<index_type>& prefix, std::vector<std::vector<index_type>>& prefixes )
+  {
+    if ( depth == 0u || items[0].rlink == 0 )
+    {
+      prefixes.push_back( prefix );
+      return;
+    }
+
+    const auto i = item_selection( items, nodes );
+    cover( i );
+    for ( auto x = nodes[i].dlink; x != i; x = nodes[x].dlink )
+    {
+      cover_option( x );
+      prefix.push_back( option_index( x ) );
+      split_run( depth - 1u, prefix, prefixes );
+      prefix.pop_back();
+      uncover_option( x );
+    }
+    uncover( i );
+  }
+
+  void prepare_symmetries()
+  {
+    if ( !symmetries_dirty )
+    {
+      return;
+    }
+    symmetries_dirty = false;
+    prepare_option_begin();
+
+    /* option permutations must cover options that were added later */
+    assert( std::all_of( option_symmetries.begin(), option_symmetries.end(), [this]( const auto& perm ) { return perm.size() == static_cast<std::size_t>( m ); } ) );
+    auto generators = option_symmetries;
+    if ( !item_symmetries.empty() )
+    {
+      std::map<std::vector<uint32_t>, uint32_t> option_by_items;
+      for ( auto o = 0u; o < option_begin.size(); ++o )
+      {
+        option_by_items[option_items( o )] = o;
+      }
+
+      for ( const auto& perm : item_symmetries )
+      {
+        std::vector<uint32_t> option_perm( m );
+        for ( auto o = 0u; o < option_begin.size(); ++o )
+        {
+          auto image = option_items( o );
+          for ( auto& j : image )
+          {
+            j = perm[j];
+          }
+          std::sort( image.begin(), image.end() );
+
+          const auto it = option_by_items.find( image );
+          assert( it != option_by_items.end() );
+          option_perm[o] = it->second;
+        }
+        generators.push_back( option_perm );
+      }
+    }
+
+    symmetries = detail::permutation_group( generators, m );
+    inverse_symmetries.clear();
+    for ( const auto& g : symmetries )
+    {
+      inverse_symmetries.push_back( detail::inverse_permutation( g ) );
+    }
+
+    option_chosen.assign( m, false );
+    item_used.assign( num_items + 1, false );
+  }
+
+  std::vector<uint32_t> option_items( uint32_t o ) const
+  {
+    std::vector<uint32_t> result;
+    for ( auto p = option_begin[o]; nodes[p].top > 0; ++p )
+    {
+      result.push_back( nodes[p].top );
+    }
+    std::sort( result.begin(), result.end() );
+    return result;
+  }
+
+  inline void mark_option( index_type x, bool value )
+  {
+    auto q = x;
+    while ( nodes[q - 1].top > 0 )
+    {
+      --q;
+    }
+    option_chosen[-nodes[q - 1].top] = value;
+    for ( ; nodes[q].top > 0; ++q )
+    {
+      item_used[nodes[q].top] = value;
+    }
+  }
+
+  /* 1 if option is chosen, 0 if it can no longer be chosen, -1 if undecided */
+  inline int option_status( uint32_t o ) const
+  {
+    if ( option_chosen[o] )
+    {
+      return 1;
+    }
+    for ( auto p = option_begin[o]; nodes[p].top > 0; ++p )
+    {
+      if ( item_used[nodes[p].top] )
+      {
+        return 0;
+      }
+    }
+    return -1;
+  }
+
+  /* false, if for some symmetry g and all completions S, g(S) < S */
+  bool is_leader_candidate() const
+  {
+    for ( const auto& ginv : inverse_symmetries )
+    {
+      for ( auto k = 0u; k < ginv.size(); ++k )
+      {
+        const auto a = option_status( k );
+        const auto b = option_status( ginv[k] );
+        if ( a == -1 || b == -1 || a > b )
+        {
+          break;
+        }
+        if ( a < b )
+        {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  /* 0, if chosen solution is not smallest in its orbit, otherwise the size of its stabilizer */
+  uint32_t leader_stabilizer() const
+  {
+    uint32_t stabilizer = 1u;
+    for ( const auto& ginv : inverse_symmetries )
+    {
+      auto k = 0u;
+      for ( ; k < ginv.size(); ++k )
+      {
+        const bool a = option_chosen[k];
+        const bool b = option_chosen[ginv[k]];
+        if ( a > b )
+        {
+          break;
+        }
+        if ( a < b )
+        {
+          return 0u;
+        }
+      }
+      if ( k == ginv.size() )
+      {
+        ++stabilizer;
+      }
+    }
+    return stabilizer;
+  }
+
 private:
-  std::vector<item> items;
-  std::vector<node> nodes;
+  typename Storage::items_type items;
+  typename Storage::nodes_type nodes;
+  typename Storage::stack_type xs;
 
   uint32_t primary_items;
   uint32_t secondary_items;
   uint32_t num_items;
-  int32_t m = 0;
+  signed_index_type m = 0;
+
+  std::vector<std::vector<uint32_t>> option_symmetries;
+  std::vector<std::vector<uint32_t>> item_symmetries;
+  std::vector<detail::permutation> symmetries;
+  std::vector<detail::permutation> inverse_symmetries;
+  typename Storage::template buffer_type<index_type> option_begin;
+  typename Storage::template buffer_type<bool> option_chosen;
+  typename Storage::template buffer_type<bool> item_used;
+  typename Storage::template buffer_type<bool> item_given;
+  bool symmetries_dirty = false;
+  uint32_t num_symmetric_solutions = 0;
+
+  search_limits limits;
+  std::chrono::steady_clock::time_point deadline;
+  uint64_t run_node_limit = std::numeric_limits<uint64_t>::max();
+  uint64_t num_nodes = 0;
+  solve_status last_status = solve_status::complete;
+  bool paused = false;
+  uint32_t paused_level = 0;
+  uint32_t paused_solutions = 0;
+
+  uint64_t progress_interval = 1u;
+  std::function<void( const search_progress& )> progress_fn;
+  search_progress progress;
+
+  typename Storage::template buffer_type<double> option_costs;
+  typename Storage::template buffer_type<double> node_cost;
+  typename Storage::template buffer_type<double> node_share;
+
+  detail::basic_failure_cache<typename key_type::allocator_type> failures;
+  key_type covered_key;
+  key_type prefix_key; /* items covered by cover_options */
+  typename Storage::template buffer_type<uint32_t> level_solutions;
+
+  std::unordered_map<key_type, uint64_t, detail::words_hash, std::equal_to<key_type>, memo_allocator_type> sample_memo;
+  key_type sample_key;
+  std::size_t sample_memo_limit = 0u;
+
+  typename Storage::template buffer_type<uint32_t> component_parent;
+  typename Storage::template buffer_type<uint32_t> touched_secondary;
+  typename Storage::template buffer_type<uint32_t> component_index;
+  typename Storage::template buffer_type<uint32_t> component_stack;
 
-  ItemSelectionFn&& item_selection;
+  ItemSelectionFn item_selection;
 };
 }
@@ -32,10 +32,29 @@
 
 #pragma once
 
+#include "allocators.hpp"
 #include "item_selection.hpp"
 #include "solver.hpp"
 
 namespace pat
 {
 using default_solver = solver<mrv_heuristic>;
+using random_solver = solver<random_mrv_heuristic>;
+using wdeg_solver = solver<weighted_degree_heuristic>;
+
+/*! \brief Solver with 16-bit indexes for problems with less than 65536 nodes */
+using compact_solver = solver<mrv_heuristic, basic_dynamic_storage<uint16_t>>;
+
+/*! \brief Solver with 64-bit indexes for problems with more than 2^31 nodes */
+using large_solver = solver<mrv_heuristic, basic_dynamic_storage<uint64_t>>;
+
+/*! \brief Solver whose buffers are allocated from an ``arena`` */
+using arena_solver = solver<mrv_heuristic, basic_dynamic_storage<uint32_t, arena_allocator<uint32_t>>>;
+
+/*! \brief Solver without heap allocation for problems of known size
+
+  See ``fixed_storage`` for the requirements on ``MaxNodes``.
+*/
+template<uint32_t PrimaryItems, uint32_t SecondaryItems, uint32_t MaxNodes, typename ItemSelectionFn = mrv_heuristic>
+using static_solver = solver<ItemSelectionFn, fixed_storage<PrimaryItems, SecondaryItems, MaxNodes>>;
 }
@@ -0,0 +1,142 @@
+/* pat: C++ dancing links solver
+ * Copyright (C) 2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file storage.hpp
+  \brief Storage policies for the solver
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "detail/fixed_vector.hpp"
+
+namespace pat
+{
+
+/*! \brief Item header with links of type ``Index`` */
+template<typename Index>
+struct basic_item
+{
+  using index_type = Index;
+
+  Index index{};
+  Index llink{};
+  Index rlink{};
+};
+
+/*! \brief Node with links of type ``Index``
+
+  The signed counterpart of ``Index`` stores the length of an item's list in
+  item nodes, the item in option nodes, and the negated option index in spacer
+  nodes.  Hence, the number of options must not exceed the largest value of
+  the signed type.
+*/
+template<typename Index>
+struct basic_node
+{
+  using index_type = Index;
+  using signed_index_type = std::make_signed_t<Index>;
+
+  union {
+    signed_index_type len{};
+    signed_index_type top;
+  };
+  Index ulink{};
+  Index dlink{};
+};
+
+using item = basic_item<uint32_t>;
+using node = basic_node<uint32_t>;
+
+/*! \brief Heap-allocated storage whose size is determined at run-time
+
+  The index type determines the maximum number of nodes and the memory
+  footprint of the matrix, e.g., with ``uint16_t`` items and nodes take half
+  the memory compared to the default ``uint32_t``, whereas ``uint64_t`` allows
+  for matrices with more than 4 billion nodes.
+
+  All buffers of the solver are allocated with (a rebound copy of) the
+  allocator that is passed to the solver's constructor, including the entries
+  of the failure cache and of the memo for uniform sampling.  Any standard
+  conforming allocator can be used, e.g., ``arena_allocator``,
+  ``huge_page_allocator``, or ``std::pmr::polymorphic_allocator`` in C++17.
+  Exceptions are declared symmetries and the group computed from them, which
+  are given as ``std::vector``s and computed once per search, as well as
+  containers returned to the caller and temporaries of setup functions such as
+  ``split`` or ``fingerprint``.
+*/
+template<typename Index = uint32_t, typename Allocator = std::allocator<Index>>
+struct basic_dynamic_storage
+{
+  static constexpr bool fixed_size = false;
+
+  using index_type = Index;
+  using allocator_type = Allocator;
+
+  template<typename T>
+  using buffer_type = std::vector<T, typename std::allocator_traits<Allocator>::template rebind_alloc<T>>;
+
+  using items_type = buffer_type<basic_item<Index>>;
+  using nodes_type = buffer_type<basic_node<Index>>;
+  using stack_type = buffer_type<Index>;
+};
+
+/*! \brief Default storage policy of ``solver`` */
+using dynamic_storage = basic_dynamic_storage<>;
+
+/*! \brief Storage whose size is known at compile-time
+
+  All buffers are ``std::array``s of the given sizes, therefore a solver with
+  this storage policy does not allocate memory during construction and search.
+  The allocator is only used for the auxiliary buffers of optional search
+  features, such as symmetry breaking.
+  ``MaxNodes`` must be at least the number of items plus 2, plus, for each
+  option, its number of items plus 1.
+*/
+template<uint32_t PrimaryItems, uint32_t SecondaryItems, uint32_t MaxNodes, typename Index = uint32_t>
+struct fixed_storage
+{
+  static constexpr bool fixed_size = true;
+  static constexpr uint32_t primary_items = PrimaryItems;
+  static constexpr uint32_t secondary_items = SecondaryItems;
+
+  using index_type = Index;
+  using allocator_type = std::allocator<Index>;
+
+  template<typename T>
+  using buffer_type = std::vector<T, std::allocator<T>>;
+
+  using items_type = detail::fixed_vector<basic_item<Index>, PrimaryItems + SecondaryItems + 1u>;
+  using nodes_type = detail::fixed_vector<basic_node<Index>, MaxNodes>;
+  using stack_type = detail::fixed_vector<Index, PrimaryItems + SecondaryItems + 1u>;
+};
+}
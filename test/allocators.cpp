@@ -0,0 +1,110 @@
+#include <catch.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <pat/pat.hpp>
+
+#include "problems.hpp"
+
+using namespace pat;
+
+template<class Solver, class... Args>
+inline auto n_queens_with_allocator( uint32_t n, Args&&... args )
+{
+  return queens_solver<Solver>( n, mrv_heuristic(), std::forward<Args>( args )... ).solve();
+}
+
+TEST_CASE( "Solver storage from an arena", "[allocators]" )
+{
+  arena a;
+
+  CHECK( n_queens_with_allocator<arena_solver>( 8, arena_allocator<uint32_t>( a ) ) == 92u );
+  const auto capacity = a.capacity();
+  CHECK( capacity > 0u );
+
+  /* reusing the arena does not allocate new chunks */
+  for ( auto k = 0u; k < 100u; ++k )
+  {
+    a.reset();
+    CHECK( n_queens_with_allocator<arena_solver>( 8, arena_allocator<uint32_t>( a ) ) == 92u );
+  }
+  CHECK( a.capacity() == capacity );
+}
+
+TEST_CASE( "Solver storage backed by huge pages", "[allocators]" )
+{
+  using huge_page_solver = solver<mrv_heuristic, basic_dynamic_storage<uint32_t, huge_page_allocator<uint32_t>>>;
+  CHECK( n_queens_with_allocator<huge_page_solver>( 8 ) == 92u );
+
+  std::vector<uint64_t, huge_page_allocator<uint64_t>> large( 1u << 20, 1u );
+  CHECK( large.back() == 1u );
+}
+
+/* counts the bytes allocated through it */
+template<typename T>
+class counting_allocator
+{
+public:
+  using value_type = T;
+
+  explicit counting_allocator( std::size_t& bytes ) noexcept
+      : bytes( &bytes ) {}
+
+  template<typename U>
+  counting_allocator( const counting_allocator<U>& other ) noexcept
+      : bytes( other.bytes ) {}
+
+  T* allocate( std::size_t n )
+  {
+    *bytes += n * sizeof( T );
+    return std::allocator<T>().allocate( n );
+  }
+
+  void deallocate( T* p, std::size_t n ) noexcept
+  {
+    std::allocator<T>().deallocate( p, n );
+  }
+
+  template<typename U>
+  bool operator==( const counting_allocator<U>& other ) const noexcept
+  {
+    return bytes == other.bytes;
+  }
+
+  template<typename U>
+  bool operator!=( const counting_allocator<U>& other ) const noexcept
+  {
+    return bytes != other.bytes;
+  }
+
+private:
+  template<typename U>
+  friend class counting_allocator;
+
+  std::size_t* bytes;
+};
+
+TEST_CASE( "Failure cache and sample memo use the solver's allocator", "[allocators]" )
+{
+  using counting_solver = solver<mrv_heuristic, basic_dynamic_storage<uint32_t, counting_allocator<uint32_t>>>;
+
+  std::size_t bytes = 0u;
+  auto solver = langford_solver<counting_solver>( 8u, mrv_heuristic(), counting_allocator<uint32_t>( bytes ) );
+
+  CHECK( solver.solve() == 300u );
+  const auto matrix_bytes = bytes;
+
+  solver.enable_failure_cache( 1024u );
+  CHECK( solver.solve() == 300u );
+  CHECK( solver.failure_cache_statistics().insertions > 0u );
+  const auto cache_bytes = bytes;
+  CHECK( cache_bytes > matrix_bytes );
+
+  std::mt19937 rng( 1 );
+  CHECK( solver.sample_uniform( 10u, rng ).size() == 10u );
+  CHECK( bytes > cache_bytes );
+}
@@ -0,0 +1,97 @@
+#include <catch.hpp>
+
+#include <cstdint>
+#include <set>
+#include <vector>
+
+#include <pat/pat.hpp>
+
+#include "problems.hpp"
+
+using namespace pat;
+
+inline exact_cover_instance knuth_example()
+{
+  exact_cover_instance instance;
+  instance.primary_items = 7u;
+  instance.options = {{3, 5}, {1, 4, 7}, {2, 3, 6}, {1, 4, 6}, {2, 7}, {4, 5, 7}};
+  return instance;
+}
+
+TEST_CASE( "Solver reset", "[batch]" )
+{
+  default_solver solver( 0u );
+  for ( auto n = 8u; n >= 4u; --n )
+  {
+    const auto instance = queens_instance( n );
+    solver.reset( instance.primary_items, instance.secondary_items );
+    for ( const auto& option : instance.options )
+    {
+      solver.add_option( option );
+    }
+    CHECK( solver.solve() == ( n == 8u ? 92u : n == 7u ? 40u : n == 6u ? 4u : n == 5u ? 10u : 2u ) );
+  }
+}
+
+TEST_CASE( "Batch of small problems on a thread pool", "[batch]" )
+{
+  const std::vector<uint32_t> expected{1u, 0u, 0u, 2u, 10u, 4u, 40u, 92u};
+
+  std::vector<exact_cover_instance> instances;
+  std::vector<uint32_t> counts;
+  for ( auto k = 0u; k < 50u; ++k )
+  {
+    instances.push_back( knuth_example() );
+    counts.push_back( 1u );
+    const auto n = 1u + k % 8u;
+    instances.push_back( queens_instance( n ) );
+    counts.push_back( expected[n - 1u] );
+  }
+
+  batch_solver<> batch( 4u );
+  for ( auto round = 0u; round < 3u; ++round )
+  {
+    const auto results = batch.solve( instances );
+    REQUIRE( results.size() == instances.size() );
+
+    auto all_equal = true;
+    for ( auto k = 0u; k < results.size(); ++k )
+    {
+      all_equal = all_equal && results[k].solutions == counts[k] && results[k].status == solve_status::complete;
+      if ( k % 2u == 0u )
+      {
+        all_equal = all_equal && results[k].first_solution == std::vector<uint32_t>{3u, 4u, 0u};
+      }
+    }
+    CHECK( all_equal );
+  }
+
+  CHECK( batch.solve( {} ).empty() );
+}
+
+TEST_CASE( "Batch of satisfiability queries", "[batch]" )
+{
+  std::vector<exact_cover_instance> instances;
+  for ( auto n = 4u; n <= 12u; ++n )
+  {
+    instances.push_back( queens_instance( n ) );
+  }
+
+  batch_solver<> batch( 2u, 1u );
+  const auto results = batch.solve( instances );
+  for ( auto k = 0u; k < results.size(); ++k )
+  {
+    const auto n = 4u + k;
+    CHECK( results[k].solutions == 1u );
+    CHECK( results[k].status == solve_status::stopped );
+
+    std::set<uint32_t> rows, cols;
+    for ( auto o : results[k].first_solution )
+    {
+      rows.insert( o / n );
+      cols.insert( o % n );
+    }
+    CHECK( rows.size() == n );
+    CHECK( cols.size() == n );
+  }
+}
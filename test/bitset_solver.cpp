@@ -0,0 +1,59 @@
+#include <catch.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <pat/pat.hpp>
+
+#include "problems.hpp"
+
+using namespace pat;
+
+TEST_CASE( "Knuth simple exact cover example with bitsets", "[bitset]" )
+{
+  bitset_solver<> solver( 7 );
+
+  solver.add_option( std::vector<uint32_t>{3, 5} );
+  solver.add_option( std::vector<uint32_t>{1, 4, 7} );
+  solver.add_option( std::vector<uint32_t>{2, 3, 6} );
+  solver.add_option( std::vector<uint32_t>{1, 4, 6} );
+  solver.add_option( std::vector<uint32_t>{2, 7} );
+  solver.add_option( std::vector<uint32_t>{4, 5, 7} );
+
+  std::string solution;
+  const auto num_solutions = solver.solve( [&solver, &solution]( const auto& begin, const auto& end ) {
+    for ( auto it = begin; it != end; ++it )
+    {
+      solution += std::to_string( solver.option_index( *it ) );
+    }
+    return true;
+  } );
+
+  CHECK( num_solutions == 1 );
+  CHECK( solution == "340" );
+}
+
+TEST_CASE( "Bitsets without options", "[bitset]" )
+{
+  CHECK( bitset_solver<>( 3 ).solve() == 0u );
+  CHECK( bitset_solver<>( 0, 2 ).solve() == 1u );
+}
+
+TEST_CASE( "n Queens with bitsets", "[bitset]" )
+{
+  for ( auto n : {4u, 8u, 10u} )
+  {
+    auto solver = queens_solver<bitset_solver<>>( n );
+
+    CHECK( solver.solve() == ( n == 4u ? 2u : n == 8u ? 92u : 724u ) );
+    CHECK( solver.solve( stop_after_first ) == 1u );
+  }
+}
+
+TEST_CASE( "Langford pairs with bitsets", "[bitset]" )
+{
+  auto solver = langford_solver<bitset_solver<64u>>( 8u );
+
+  CHECK( solver.solve() == 300u );
+}
@@ -0,0 +1,151 @@
+#include <catch.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include <pat/pat.hpp>
+
+#include "problems.hpp"
+
+using namespace pat;
+
+TEST_CASE( "Queries on cached instances of a daemon", "[daemon]" )
+{
+  const auto path = "/tmp/pat-test-" + std::to_string( getpid() ) + "-daemon.sock";
+
+  solve_daemon<> daemon( path, 2u );
+  std::thread server( [&]() { daemon.run(); } );
+
+  {
+    daemon_client client( path );
+
+    const auto queens = client.load( queens_instance( 8u ) );
+    CHECK( client.load( queens_instance( 8u ) ) == queens );
+
+    const auto all = client.count( queens );
+    CHECK( all.status == solve_status::complete );
+    CHECK( all.count == 92u );
+    CHECK( all.solution.size() == 8u );
+
+    const auto one = client.first( queens );
+    CHECK( one.status == solve_status::stopped );
+    CHECK( one.count == 1u );
+    std::set<uint64_t> rows, cols;
+    for ( auto o : one.solution )
+    {
+      rows.insert( o / 8u );
+      cols.insert( o % 8u );
+    }
+    CHECK( rows.size() == 8u );
+    CHECK( cols.size() == 8u );
+
+    /* queen in a corner, and two queens attacking each other */
+    CHECK( client.forced( queens, {0u} ).count == 4u );
+    CHECK( client.forced( queens, {0u} ).solution.front() == 0u );
+    CHECK( client.forced( queens, {0u, 9u} ).count == 0u );
+
+    /* the cached matrix is not changed by queries */
+    CHECK( client.count( queens ).count == 92u );
+
+    /* a second client shares the cache, the least recently used entry is evicted */
+    daemon_client other( path );
+    const auto small = other.load( queens_instance( 6u ) );
+    CHECK( other.count( small ).count == 4u );
+    CHECK( client.count( queens ).count == 92u );
+    other.load( queens_instance( 5u ) );
+    CHECK_THROWS_AS( other.count( small ), std::out_of_range );
+    CHECK( client.count( queens ).count == 92u );
+
+    const auto stats = daemon.statistics();
+    CHECK( stats.loads == 3u );
+    CHECK( stats.hits == 1u );
+    CHECK( stats.evictions == 1u );
+
+    client.shutdown();
+  }
+
+  server.join();
+}
+
+TEST_CASE( "Daemon rejects malformed messages", "[daemon]" )
+{
+  const auto path = "/tmp/pat-test-" + std::to_string( getpid() ) + "-malformed.sock";
+
+  solve_daemon<> daemon( path, 2u );
+  std::thread server( [&]() { daemon.run(); } );
+
+  {
+    const auto fd = detail::connect_socket( path );
+    detail::daemon_message type;
+    std::vector<uint64_t> reply;
+
+    /* option length beyond the payload */
+    CHECK( detail::send_message( fd, detail::daemon_message::load, std::vector<uint64_t>{2u, 0u, 5u, 1u} ) );
+    CHECK( detail::receive_message( fd, type, reply ) );
+    CHECK( type == detail::daemon_message::error );
+
+    /* too many items */
+    CHECK( detail::send_message( fd, detail::daemon_message::load, std::vector<uint64_t>{~uint64_t( 0u ), 1u} ) );
+    CHECK( detail::receive_message( fd, type, reply ) );
+    CHECK( type == detail::daemon_message::error );
+    CHECK( detail::send_message( fd, detail::daemon_message::load, std::vector<uint64_t>{uint64_t( 1u ) << 26u, 0u, 1u} ) );
+    CHECK( detail::receive_message( fd, type, reply ) );
+    CHECK( type == detail::daemon_message::error );
+
+    /* a header with a huge payload closes the connection */
+    const uint64_t header[2] = {static_cast<uint64_t>( detail::daemon_message::load ), uint64_t( 1u ) << 40u};
+    CHECK( detail::write_all( fd, header, sizeof( header ) ) );
+    CHECK( !detail::receive_message( fd, type, reply ) );
+    ::close( fd );
+
+    /* forced options out of range */
+    daemon_client client( path );
+    const auto queens = client.load( queens_instance( 6u ) );
+    CHECK_THROWS_AS( client.forced( queens, {36u} ), std::out_of_range );
+    CHECK_THROWS_AS( client.forced( queens, {uint64_t( 1u ) << 32u} ), std::out_of_range );
+    CHECK( client.count( queens ).count == 4u );
+    client.shutdown();
+  }
+
+  server.join();
+}
+
+TEST_CASE( "Daemon queries are bounded and cancelled on stop", "[daemon]" )
+{
+  const auto path = "/tmp/pat-test-" + std::to_string( getpid() ) + "-limits.sock";
+
+  search_limits limits;
+  limits.max_nodes = 1000u;
+  solve_daemon<> daemon( path, 2u, limits );
+  std::thread server( [&]() { daemon.run(); } );
+
+  {
+    daemon_client client( path );
+    const auto queens = client.load( queens_instance( 16u ) );
+    CHECK( client.count( queens ).status == solve_status::budget_exhausted );
+    client.shutdown();
+  }
+  server.join();
+
+  /* a long query does not block stopping the daemon */
+  solve_daemon<> unbounded( path );
+  std::thread unbounded_server( [&]() { unbounded.run(); } );
+
+  daemon_client client( path );
+  const auto queens = client.load( queens_instance( 16u ) );
+  daemon_answer answer;
+  std::thread query( [&]() { answer = client.count( queens ); } );
+
+  std::this_thread::sleep_for( std::chrono::milliseconds( 200 ) );
+  unbounded.stop();
+  unbounded_server.join();
+  query.join();
+  CHECK( answer.status == solve_status::cancelled );
+}
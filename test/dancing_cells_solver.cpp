@@ -0,0 +1,68 @@
+#include <catch.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <pat/pat.hpp>
+
+#include "problems.hpp"
+
+using namespace pat;
+
+TEST_CASE( "Knuth simple exact cover example with dancing cells", "[dancing_cells]" )
+{
+  dancing_cells_solver solver( 7 );
+
+  solver.add_option( std::vector<uint32_t>{3, 5} );
+  solver.add_option( std::vector<uint32_t>{1, 4, 7} );
+  solver.add_option( std::vector<uint32_t>{2, 3, 6} );
+  solver.add_option( std::vector<uint32_t>{1, 4, 6} );
+  solver.add_option( std::vector<uint32_t>{2, 7} );
+  solver.add_option( std::vector<uint32_t>{4, 5, 7} );
+
+  std::string solution;
+  const auto num_solutions = solver.solve( [&solver, &solution]( const auto& begin, const auto& end ) {
+    for ( auto it = begin; it != end; ++it )
+    {
+      solution += std::to_string( solver.option_index( *it ) );
+    }
+    return true;
+  } );
+
+  CHECK( num_solutions == 1 );
+  CHECK( solution == "340" );
+}
+
+TEST_CASE( "n Queens with dancing cells", "[dancing_cells]" )
+{
+  auto solver = queens_solver<dancing_cells_solver>( 10u );
+
+  CHECK( solver.solve() == 724u );
+  CHECK( solver.solve( stop_after( 5u ) ) == 5u );
+  CHECK( solver.solve() == 724u );
+}
+
+TEST_CASE( "Langford pairs and leafy majority graphs with dancing cells", "[dancing_cells]" )
+{
+  auto langford = langford_solver<dancing_cells_solver>( 8u );
+  CHECK( langford.solve() == 300u );
+
+  const auto m = 6u;
+  dancing_cells_solver dags( m, ( m * ( m - 1 ) ) / 2 );
+  auto offset = m;
+  for ( auto i = 1u; i <= m; ++i )
+  {
+    dags.add_option( std::vector<uint32_t>{i} );
+    for ( auto j = 1u; j < i; ++j )
+    {
+      dags.add_option( std::vector<uint32_t>{i, offset + j} );
+      for ( auto k = j + 1; k < i; ++k )
+      {
+        dags.add_option( std::vector<uint32_t>{i, offset + j, offset + k} );
+      }
+    }
+    offset += i - 1;
+  }
+  CHECK( dags.solve() == 9856u );
+}
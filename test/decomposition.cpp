@@ -0,0 +1,58 @@
+#include <catch.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include <pat/pat.hpp>
+
+#include "problems.hpp"
+
+using namespace pat;
+
+/* k disjoint copies of the Langford pairs problem for n */
+inline auto disjoint_langford_pairs( unsigned n, unsigned k )
+{
+  default_solver solver( 3 * n * k );
+
+  for ( auto c = 0u; c < k; ++c )
+  {
+    for ( const auto& option : langford_options( n, 3 * n * c ) )
+    {
+      solver.add_option( option );
+    }
+  }
+
+  return solver;
+}
+
+TEST_CASE( "Disjoint Langford pairs with decomposition", "[examples]" )
+{
+  CHECK( disjoint_langford_pairs( 4, 2 ).solve() == 4u );
+  CHECK( disjoint_langford_pairs( 4, 2 ).solve_decomposed() == 4u );
+  CHECK( disjoint_langford_pairs( 5, 2 ).solve_decomposed() == 0u );
+  CHECK( disjoint_langford_pairs( 8, 3 ).solve_decomposed() == 300u * 300u * 300u );
+}
+
+TEST_CASE( "Leafy majority graphs with decomposition", "[examples]" )
+{
+  const auto n = 6u;
+  default_solver solver( n, ( n * ( n - 1 ) ) / 2 );
+
+  auto offset = n;
+  for ( auto i = 1u; i <= n; ++i )
+  {
+    solver.add_option( std::vector<uint32_t>{i} );
+    for ( auto j = 1u; j < i; ++j )
+    {
+      solver.add_option( std::vector<uint32_t>{i, offset + j} );
+      for ( auto k = j + 1; k < i; ++k )
+      {
+        solver.add_option( std::vector<uint32_t>{i, offset + j, offset + k} );
+      }
+    }
+    offset += i - 1;
+  }
+
+  CHECK( solver.solve_decomposed() == 9856u );
+  CHECK( solver.solve() == 9856u );
+}
@@ -0,0 +1,207 @@
+#include <catch.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <pat/pat.hpp>
+
+#include "problems.hpp"
+
+using namespace pat;
+
+/* forks workers that build their own solver and run until the coordinator is done */
+template<class Build>
+inline std::vector<pid_t> fork_workers( const std::string& path, unsigned count, uint64_t node_budget, Build&& build )
+{
+  std::vector<pid_t> pids;
+  for ( auto k = 0u; k < count; ++k )
+  {
+    const auto pid = fork();
+    if ( pid == 0 )
+    {
+      auto solver = build();
+      try
+      {
+        run_worker( path, solver, node_budget );
+      }
+      catch ( ... )
+      {
+        _exit( 1 );
+      }
+      _exit( 0 );
+    }
+    pids.push_back( pid );
+  }
+  return pids;
+}
+
+inline bool join_workers( const std::vector<pid_t>& pids )
+{
+  auto ok = true;
+  for ( auto pid : pids )
+  {
+    int status;
+    ok = waitpid( pid, &status, 0 ) == pid && WIFEXITED( status ) && WEXITSTATUS( status ) == 0 && ok;
+  }
+  return ok;
+}
+
+TEST_CASE( "Splitting the search tree into prefixes", "[distributed]" )
+{
+  auto solver = langford_solver( 8u );
+
+  uint64_t count = 0u;
+  for ( const auto& prefix : solver.split( {}, 2u ) )
+  {
+    CHECK( prefix.size() == 2u );
+    for ( const auto& child : solver.split( prefix, 1u ) )
+    {
+      count += solver.solve_prefix( child );
+    }
+  }
+  CHECK( count == 300u );
+
+  /* the matrix is restored */
+  CHECK( solver.solve() == 300u );
+}
+
+TEST_CASE( "Langford pairs with coordinator and worker processes", "[distributed]" )
+{
+  const auto path = "/tmp/pat-test-" + std::to_string( getpid() ) + ".sock";
+  const auto build = []() { return langford_solver( 11u ); };
+
+  coordinator coord( path );
+  const auto pids = fork_workers( path, 3u, 500u, build );
+
+  auto solver = build();
+  const auto result = coord.run( solver, 1u );
+  CHECK( join_workers( pids ) );
+
+  CHECK( result.count == 35584u );
+  CHECK( result.resplits != 0u );
+  CHECK( result.prefixes != 0u );
+}
+
+TEST_CASE( "n Queens solutions with coordinator and worker processes", "[distributed]" )
+{
+  const uint32_t n = 8u;
+  const auto path = "/tmp/pat-test-" + std::to_string( getpid() ) + "-queens.sock";
+  const auto build = [n]() { return queens_solver( n ); };
+
+  coordinator coord( path );
+  const auto pids = fork_workers( path, 2u, 20u, build );
+
+  auto solver = build();
+  const auto result = coord.run( solver, 2u, true );
+  CHECK( join_workers( pids ) );
+
+  CHECK( result.count == 92u );
+  REQUIRE( result.solutions.size() == 92u );
+
+  auto valid = true;
+  std::set<std::vector<uint64_t>> distinct;
+  for ( auto solution : result.solutions )
+  {
+    std::set<uint64_t> rows, cols;
+    for ( auto o : solution )
+    {
+      rows.insert( o / n );
+      cols.insert( o % n );
+    }
+    valid = valid && rows.size() == n && cols.size() == n;
+    std::sort( solution.begin(), solution.end() );
+    distinct.insert( solution );
+  }
+  CHECK( valid );
+  CHECK( distinct.size() == 92u );
+}
+
+TEST_CASE( "Coordinator hands out the prefix of a misbehaving worker again", "[distributed]" )
+{
+  const auto path = "/tmp/pat-test-" + std::to_string( getpid() ) + "-busy.sock";
+  const auto build = []() { return langford_solver( 8u ); };
+
+  coordinator coord( path );
+  int started[2];
+  REQUIRE( pipe( started ) == 0 );
+
+  /* requests more work before answering, and waits for the coordinator to disconnect */
+  const auto pid = fork();
+  if ( pid == 0 )
+  {
+    const auto fd = detail::connect_socket( path );
+    detail::message type;
+    std::vector<uint64_t> payload;
+    auto ok = detail::send_message( fd, detail::message::request ) && detail::receive_message( fd, type, payload ) && type == detail::message::work;
+    ok = ok && write( started[1], "x", 1 ) == 1;
+    ok = ok && detail::send_message( fd, detail::message::request ) && !detail::receive_message( fd, type, payload );
+    _exit( ok ? 0 : 1 );
+  }
+
+  /* the well-behaved worker starts once the other one has a prefix */
+  auto pids = fork_workers( path, 1u, 1000u, [&]() {
+    char c;
+    (void)read( started[0], &c, 1 );
+    return build();
+  } );
+  pids.push_back( pid );
+
+  auto solver = build();
+  const auto result = coord.run( solver, 1u );
+  CHECK( join_workers( pids ) );
+  CHECK( result.count == 300u );
+  ::close( started[0] );
+  ::close( started[1] );
+}
+
+TEST_CASE( "Worker disconnects on unknown options and cancellation", "[distributed]" )
+{
+  const auto path = "/tmp/pat-test-" + std::to_string( getpid() ) + "-worker.sock";
+  const auto listener = detail::listen_socket( path );
+
+  for ( auto cancelled : {false, true} )
+  {
+    const auto pid = fork();
+    if ( pid == 0 )
+    {
+      auto solver = langford_solver( 11u );
+      const std::atomic<bool> cancel( cancelled );
+      search_limits limits;
+      limits.cancel = &cancel;
+      limits.check_interval = 1u;
+      solver.set_limits( limits );
+      _exit( run_worker( path, solver ) == 0u ? 0 : 1 );
+    }
+
+    const auto fd = ::accept( listener, nullptr, nullptr );
+    detail::message type;
+    std::vector<uint64_t> payload;
+    CHECK( detail::receive_message( fd, type, payload ) );
+    CHECK( type == detail::message::request );
+
+    /* option indices are checked, and a cancelled search is not split */
+    const auto work = cancelled ? std::vector<uint64_t>{0u, 0u} : std::vector<uint64_t>{0u, 0u, uint64_t( 1u ) << 32u};
+    CHECK( detail::send_message( fd, detail::message::work, work ) );
+    CHECK( !detail::receive_message( fd, type, payload ) );
+    ::close( fd );
+    CHECK( join_workers( {pid} ) );
+  }
+
+  ::close( listener );
+  ::unlink( path.c_str() );
+}
+
+TEST_CASE( "Reading length-prefixed lists", "[distributed]" )
+{
+  std::vector<std::vector<uint64_t>> lists;
+  CHECK( detail::read_lists( {7u, 2u, 1u, 2u, 0u, 1u, 3u}, 1u, lists ) );
+  CHECK( lists == std::vector<std::vector<uint64_t>>{{1u, 2u}, {}, {3u}} );
+  CHECK( !detail::read_lists( {2u, 1u}, 0u, lists ) );
+  CHECK( !detail::read_lists( {~uint64_t( 0u ), 1u}, 0u, lists ) );
+}
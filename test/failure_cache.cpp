@@ -0,0 +1,70 @@
+#include <catch.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include <pat/pat.hpp>
+
+#include "problems.hpp"
+
+using namespace pat;
+
+TEST_CASE( "Failure cache on unsatisfiable Langford pairs", "[failure_cache]" )
+{
+  auto solver = langford_solver( 9 );
+
+  CHECK( solver.solve( stop_after_first ) == 0u );
+  const auto nodes_without_cache = solver.nodes_visited();
+
+  solver.enable_failure_cache( 1u << 16 );
+  CHECK( solver.solve( stop_after_first ) == 0u );
+  CHECK( solver.nodes_visited() < nodes_without_cache );
+
+  const auto& stats = solver.failure_cache_statistics();
+  CHECK( stats.hits > 0u );
+  CHECK( stats.insertions > 0u );
+  CHECK( stats.hit_rate() > 0.0 );
+}
+
+TEST_CASE( "Failure cache preserves solution counts", "[failure_cache]" )
+{
+  auto solver = langford_solver( 8 );
+  solver.enable_failure_cache( 64u );
+  CHECK( solver.solve() == 300u );
+  CHECK( solver.failure_cache_statistics().evictions > 0u );
+  CHECK( solver.solve( stop_after_first ) == 1u );
+  CHECK( solver.solve() == 300u );
+}
+
+TEST_CASE( "Failure cache keys include the items of a prefix", "[failure_cache]" )
+{
+  solver<pick_first> solver( 4u );
+  solver.add_option( std::vector<uint32_t>{2} );
+  solver.add_option( std::vector<uint32_t>{1} );
+  solver.add_option( std::vector<uint32_t>{2, 3, 4} );
+  solver.enable_failure_cache( 16u );
+
+  CHECK( solver.solve_prefix( {0} ) == 0u );
+  CHECK( solver.solve() == 1u );
+  CHECK( solver.check_uniqueness( {1} ) == uniqueness::unique );
+  CHECK( solver.solve_given( {0} ) == 0u );
+  CHECK( solver.solve() == 1u );
+}
+
+TEST_CASE( "Failure cache counters accumulate over prefix searches", "[failure_cache]" )
+{
+  auto solver = langford_solver( 9 );
+  solver.enable_failure_cache( 1u << 16 );
+
+  CHECK( solver.solve_given( {}, stop_after_first ) == 0u );
+  const auto stats = solver.failure_cache_statistics();
+  CHECK( stats.lookups > 0u );
+  CHECK( stats.hits > 0u );
+
+  /* failures recorded without a prefix prune the search below one */
+  const auto nodes = solver.nodes_visited();
+  CHECK( solver.solve_prefix( {0} ) == 0u );
+  CHECK( solver.nodes_visited() < nodes );
+  CHECK( solver.failure_cache_statistics().lookups > stats.lookups );
+  CHECK( solver.failure_cache_statistics().hits > stats.hits );
+}
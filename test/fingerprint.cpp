@@ -0,0 +1,201 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include <pat/pat.hpp>
+
+#include "problems.hpp"
+
+using namespace pat;
+
+/* options of n Queens, where rows and columns are numbered by a permutation */
+inline std::vector<std::vector<uint32_t>> renamed_queens_options( uint32_t n, const std::vector<uint32_t>& rename )
+{
+  auto options = queens_options( n );
+  for ( auto& option : options )
+  {
+    option[0] = rename[option[0]];
+    option[1] = rename[option[1]];
+  }
+  return options;
+}
+
+inline default_solver make_solver( uint32_t n, const std::vector<std::vector<uint32_t>>& options )
+{
+  default_solver solver( 2 * n, 4 * n - 2 );
+  for ( const auto& option : options )
+  {
+    solver.add_option( option );
+  }
+  return solver;
+}
+
+TEST_CASE( "Fingerprints of permuted instances", "[fingerprint]" )
+{
+  const uint32_t n = 8u;
+  std::vector<uint32_t> identity( 2 * n + 1u );
+  for ( auto j = 0u; j < identity.size(); ++j )
+  {
+    identity[j] = j;
+  }
+
+  auto options = queens_options( n );
+  const auto original = make_solver( n, options );
+
+  /* shuffle options and items within options */
+  std::mt19937_64 rng( 7 );
+  std::shuffle( options.begin(), options.end(), rng );
+  for ( auto& option : options )
+  {
+    std::shuffle( option.begin(), option.end(), rng );
+  }
+  const auto shuffled = make_solver( n, options );
+  CHECK( shuffled.fingerprint() == original.fingerprint() );
+  CHECK( shuffled.fingerprint( true ) == original.fingerprint( true ) );
+
+  /* renumber primary items */
+  auto rename = identity;
+  std::shuffle( rename.begin() + 1, rename.end(), rng );
+  const auto renamed = make_solver( n, renamed_queens_options( n, rename ) );
+  CHECK( renamed.fingerprint() != original.fingerprint() );
+  CHECK( renamed.fingerprint( true ) == original.fingerprint( true ) );
+
+  /* different problems */
+  options.pop_back();
+  const auto smaller = make_solver( n, options );
+  CHECK( smaller.fingerprint() != original.fingerprint() );
+  CHECK( smaller.fingerprint( true ) != original.fingerprint( true ) );
+  CHECK( make_solver( 7u, queens_options( 7u ) ).fingerprint( true ) != original.fingerprint( true ) );
+}
+
+TEST_CASE( "On-disk result cache", "[fingerprint]" )
+{
+  char directory[] = "/tmp/pat-cache-XXXXXX";
+  REQUIRE( mkdtemp( directory ) != nullptr );
+
+  const uint32_t n = 8u;
+  std::vector<uint32_t> rename( 2 * n + 1u );
+  for ( auto j = 0u; j < rename.size(); ++j )
+  {
+    rename[j] = j == 0u ? 0u : ( j <= n ? n + 1u - j : 3 * n + 1u - j );
+  }
+
+  auto options = queens_options( n );
+  {
+    result_cache cache( directory );
+    auto solver = make_solver( n, options );
+    CHECK( solve_cached( solver, cache ) == 92u );
+    CHECK( cache.statistics().hits == 0u );
+    CHECK( cache.statistics().insertions == 1u );
+  }
+
+  /* a new cache on the same directory returns the count of the permuted instance */
+  {
+    result_cache cache( directory );
+    std::reverse( options.begin(), options.end() );
+    auto solver = make_solver( n, options );
+    CHECK( solve_cached( solver, cache ) == 92u );
+    CHECK( cache.statistics().hits == 1u );
+    CHECK( solver.nodes_visited() == 0u );
+
+    /* renumbered instances are different problems for the cache */
+    auto renamed = make_solver( n, renamed_queens_options( n, rename ) );
+    CHECK( solve_cached( renamed, cache ) == 92u );
+    CHECK( cache.statistics().hits == 1u );
+    CHECK( cache.statistics().insertions == 1u );
+  }
+
+  CHECK( std::system( ( std::string( "rm -r " ) + directory ).c_str() ) == 0 );
+}
+
+TEST_CASE( "Result cache rejects colliding fingerprints", "[fingerprint]" )
+{
+  char directory[] = "/tmp/pat-cache-XXXXXX";
+  REQUIRE( mkdtemp( directory ) != nullptr );
+
+  /* perfect matchings of a 6-cycle and of two triangles, which colour refinement cannot distinguish */
+  default_solver cycle( 6u ), triangles( 6u );
+  for ( auto j = 1u; j <= 6u; ++j )
+  {
+    cycle.add_option( std::vector<uint32_t>{j, j % 6u + 1u} );
+    triangles.add_option( std::vector<uint32_t>{j, j % 3u == 0u ? j - 2u : j + 1u} );
+  }
+  REQUIRE( cycle.fingerprint( true ) == triangles.fingerprint( true ) );
+  REQUIRE( cycle.canonical_form() != triangles.canonical_form() );
+
+  result_cache cache( directory );
+  CHECK( solve_cached( cycle, cache ) == 2u );
+
+  /* an entry of another problem under the same key is not a hit */
+  cache.store( triangles.fingerprint(), cycle.canonical_form(), 2u );
+  CHECK( solve_cached( triangles, cache ) == 0u );
+  CHECK( cache.statistics().hits == 0u );
+  CHECK( solve_cached( triangles, cache ) == 0u );
+  CHECK( cache.statistics().hits == 1u );
+
+  CHECK( std::system( ( std::string( "rm -r " ) + directory ).c_str() ) == 0 );
+}
+
+TEST_CASE( "Result cache counts do not depend on symmetries", "[fingerprint]" )
+{
+  char directory[] = "/tmp/pat-cache-XXXXXX";
+  REQUIRE( mkdtemp( directory ) != nullptr );
+
+  result_cache cache( directory );
+  auto symmetric = langford_solver( 8u );
+  std::vector<uint32_t> reversal( 25u );
+  for ( auto j = 1u; j <= 24u; ++j )
+  {
+    reversal[j] = j <= 16u ? 17u - j : j;
+  }
+  symmetric.add_item_symmetry( reversal );
+  CHECK( solve_cached( symmetric, cache ) == 300u );
+
+  auto plain = langford_solver( 8u );
+  CHECK( solve_cached( plain, cache ) == 300u );
+  CHECK( cache.statistics().hits == 1u );
+
+  CHECK( std::system( ( std::string( "rm -r " ) + directory ).c_str() ) == 0 );
+}
+
+TEST_CASE( "Result cache shared by threads", "[fingerprint]" )
+{
+  char directory[] = "/tmp/pat-cache-XXXXXX";
+  REQUIRE( mkdtemp( directory ) != nullptr );
+
+  /* all threads store the same entry */
+  result_cache cache( directory );
+  const auto solver = queens_solver( 6u );
+  const auto key = solver.fingerprint();
+  const auto form = solver.canonical_form();
+  std::vector<std::thread> threads;
+  for ( auto k = 0u; k < 4u; ++k )
+  {
+    threads.emplace_back( [&]() {
+      result_cache own( directory );
+      for ( auto r = 0u; r < 100u; ++r )
+      {
+        own.store( key, form, 4u );
+      }
+    } );
+  }
+  for ( auto& t : threads )
+  {
+    t.join();
+  }
+
+  uint64_t count;
+  CHECK( cache.lookup( key, form, count ) );
+  CHECK( count == 4u );
+  CHECK( std::system( ( std::string( "ls " ) + directory + " | grep -q tmp" ).c_str() ) != 0 );
+
+  CHECK( std::system( ( std::string( "rm -r " ) + directory ).c_str() ) == 0 );
+}
@@ -2,10 +2,13 @@
 
 #include <cstdint>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <pat/pat.hpp>
 
+#include "problems.hpp"
+
 using namespace pat;
 
 inline auto langford_pairs( unsigned n )
@@ -27,6 +30,22 @@ inline auto langford_pairs( unsigned n )
   return solver.solve();
 }
 
+inline auto langford_pairs_symmetric( unsigned n )
+{
+  auto solver = langford_solver( n );
+
+  /* reversing the sequence maps each position j to 2n + 1 - j */
+  std::vector<uint32_t> reversal( 3 * n + 1 );
+  for ( auto j = 1u; j <= 3 * n; ++j )
+  {
+    reversal[j] = j <= 2 * n ? 2 * n + 1 - j : j;
+  }
+  solver.add_item_symmetry( reversal );
+
+  const auto orbits = solver.solve();
+  return std::make_pair( orbits, solver.symmetric_solutions() );
+}
+
 TEST_CASE( "Langford pairs example", "[examples]" )
 {
   CHECK( langford_pairs( 3 ) == 2 );
@@ -35,3 +54,45 @@ TEST_CASE( "Langford pairs example", "[examples]" )
   CHECK( langford_pairs( 8 ) == 300 );
   CHECK( langford_pairs( 11 ) == 35584 );
 }
+
+TEST_CASE( "Langford pairs with symmetry breaking", "[examples]" )
+{
+  CHECK( langford_pairs_symmetric( 3 ) == std::make_pair( 1u, 2u ) );
+  CHECK( langford_pairs_symmetric( 5 ) == std::make_pair( 0u, 0u ) );
+  CHECK( langford_pairs_symmetric( 8 ) == std::make_pair( 150u, 300u ) );
+  CHECK( langford_pairs_symmetric( 11 ) == std::make_pair( 17792u, 35584u ) );
+}
+
+TEST_CASE( "Langford pairs with options added after solving", "[examples]" )
+{
+  const auto n = 8u;
+  default_solver solver( 3 * n );
+
+  std::vector<uint32_t> reversal( 3 * n + 1 );
+  for ( auto j = 1u; j <= 3 * n; ++j )
+  {
+    reversal[j] = j <= 2 * n ? 2 * n + 1 - j : j;
+  }
+  solver.add_item_symmetry( reversal );
+
+  /* without the options for the largest pair, there is no solution */
+  const auto options = langford_options( n );
+  for ( const auto& option : options )
+  {
+    if ( option[0] != 3 * n )
+    {
+      solver.add_option( option );
+    }
+  }
+  CHECK( solver.solve() == 0u );
+  for ( const auto& option : options )
+  {
+    if ( option[0] == 3 * n )
+    {
+      solver.add_option( option );
+    }
+  }
+
+  CHECK( solver.solve() == 150u );
+  CHECK( solver.symmetric_solutions() == 300u );
+}
@@ -0,0 +1,83 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include <pat/pat.hpp>
+
+#include "problems.hpp"
+
+using namespace pat;
+
+TEST_CASE( "Node budget", "[limits]" )
+{
+  auto solver = queens_solver( 10 );
+
+  search_limits limits;
+  limits.max_nodes = 1000u;
+  solver.set_limits( limits );
+
+  const auto partial = solver.solve();
+  CHECK( solver.status() == solve_status::budget_exhausted );
+  CHECK( solver.nodes_visited() == 1000u );
+  CHECK( partial < 724u );
+
+  solver.set_limits( search_limits() );
+  CHECK( solver.solve() == 724u );
+  CHECK( solver.status() == solve_status::complete );
+  CHECK( solver.nodes_visited() > 1000u );
+}
+
+TEST_CASE( "Time budget and cancellation", "[limits]" )
+{
+  auto solver = queens_solver( 10 );
+
+  search_limits limits;
+  limits.max_time = std::chrono::steady_clock::duration::zero();
+  limits.check_interval = 16u;
+  solver.set_limits( limits );
+  solver.solve();
+  CHECK( solver.status() == solve_status::budget_exhausted );
+  CHECK( solver.nodes_visited() <= 17u );
+
+  std::atomic<bool> cancel{true};
+  limits = search_limits();
+  limits.cancel = &cancel;
+  limits.check_interval = 16u;
+  solver.set_limits( limits );
+  solver.solve();
+  CHECK( solver.status() == solve_status::cancelled );
+
+  cancel = false;
+  CHECK( solver.solve() == 724u );
+  CHECK( solver.status() == solve_status::complete );
+
+  CHECK( solver.solve( stop_after_first ) == 1u );
+  CHECK( solver.status() == solve_status::stopped );
+}
+
+TEST_CASE( "Progress reporting", "[limits]" )
+{
+  auto solver = queens_solver( 10 );
+
+  std::vector<double> estimates;
+  auto consistent = true;
+  solver.set_progress( 50u, [&]( const search_progress& progress ) {
+    estimates.push_back( progress.estimate );
+    consistent = consistent && progress.nodes % 50u == 0u && progress.positions.size() == progress.level;
+    for ( auto k = 0u; k < progress.level; ++k )
+    {
+      consistent = consistent && progress.positions[k] < progress.lengths[k];
+    }
+  } );
+
+  CHECK( solver.solve() == 724u );
+  CHECK( consistent );
+  CHECK( estimates.size() == solver.nodes_visited() / 50u );
+  CHECK( std::is_sorted( estimates.begin(), estimates.end() ) );
+  CHECK( estimates.front() > 0.0 );
+  CHECK( estimates.back() < 1.0 );
+}
@@ -0,0 +1,119 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <pat/pat.hpp>
+
+#include "problems.hpp"
+
+using namespace pat;
+
+TEST_CASE( "Minimum cost exact cover", "[min_cost]" )
+{
+  default_solver solver( 4 );
+
+  solver.add_option( std::vector<uint32_t>{1, 2}, 3.0 );
+  solver.add_option( std::vector<uint32_t>{3, 4}, 3.0 );
+  solver.add_option( std::vector<uint32_t>{1}, 1.0 );
+  solver.add_option( std::vector<uint32_t>{2}, 1.5 );
+  solver.add_option( std::vector<uint32_t>{3}, 2.5 );
+  solver.add_option( std::vector<uint32_t>{4}, 1.0 );
+  solver.add_option( std::vector<uint32_t>{1, 2, 3, 4}, 7.0 );
+
+  std::string solution;
+  const auto cost = solver.solve_min_cost( [&]( auto begin, auto end ) {
+    solution.clear();
+    for ( auto it = begin; it != end; ++it )
+    {
+      solution += std::to_string( solver.option_index( *it ) );
+    }
+    std::sort( solution.begin(), solution.end() );
+    return true;
+  } );
+
+  CHECK( cost == 5.5 );
+  CHECK( solution == "123" );
+  CHECK( solver.solve() == 5u );
+}
+
+TEST_CASE( "Minimum cost n Queens with random costs", "[min_cost]" )
+{
+  const uint32_t n = 8;
+  std::mt19937 rng( 42 );
+  std::uniform_int_distribution<uint32_t> dist( 1u, 100u );
+
+  default_solver solver( 2 * n, 4 * n - 2 );
+  std::vector<double> costs;
+  for ( const auto& option : queens_options( n ) )
+  {
+    costs.push_back( dist( rng ) );
+    solver.add_option( option, costs.back() );
+  }
+
+  /* exhaustive enumeration */
+  auto expected = std::numeric_limits<double>::infinity();
+  solver.solve( [&]( auto begin, auto end ) {
+    auto cost = 0.0;
+    for ( auto it = begin; it != end; ++it )
+    {
+      cost += costs[solver.option_index( *it )];
+    }
+    expected = std::min( expected, cost );
+    return true;
+  } );
+
+  auto improvements = 0u;
+  CHECK( solver.solve_min_cost( [&]( auto, auto ) { ++improvements; return true; } ) == expected );
+  CHECK( improvements >= 1u );
+  CHECK( solver.solve() == 92u );
+}
+
+TEST_CASE( "Minimum cost without solution", "[min_cost]" )
+{
+  default_solver solver( 3 );
+  solver.add_option( std::vector<uint32_t>{1, 2}, 1.0 );
+  solver.add_option( std::vector<uint32_t>{2, 3}, 1.0 );
+
+  CHECK( solver.solve_min_cost() == std::numeric_limits<double>::infinity() );
+}
+
+TEST_CASE( "Top-k cheapest n Queens with random costs", "[min_cost]" )
+{
+  const uint32_t n = 8, k = 10;
+  std::mt19937 rng( 7 );
+  std::uniform_int_distribution<uint32_t> dist( 1u, 1000u );
+
+  default_solver solver( 2 * n, 4 * n - 2 );
+  std::vector<double> costs;
+  for ( const auto& option : queens_options( n ) )
+  {
+    costs.push_back( dist( rng ) );
+    solver.add_option( option, costs.back() );
+  }
+
+  const auto cost_of = [&]( auto begin, auto end ) {
+    auto cost = 0.0;
+    for ( auto it = begin; it != end; ++it )
+    {
+      cost += costs[solver.option_index( *it )];
+    }
+    return cost;
+  };
+
+  std::vector<double> all;
+  solver.solve( [&]( auto begin, auto end ) { all.push_back( cost_of( begin, end ) ); return true; } );
+  std::sort( all.begin(), all.end() );
+
+  std::vector<double> best;
+  CHECK( solver.solve_top_k( k, [&]( auto begin, auto end ) { best.push_back( cost_of( begin, end ) ); } ) == k );
+  CHECK( best == std::vector<double>( all.begin(), all.begin() + k ) );
+
+  best.clear();
+  CHECK( solver.solve_top_k( 200u, [&]( auto begin, auto end ) { best.push_back( cost_of( begin, end ) ); } ) == 92u );
+  CHECK( best == all );
+}
@@ -0,0 +1,124 @@
+#include <catch.hpp>
+
+#include <cstdint>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <pat/pat.hpp>
+
+#include "problems.hpp"
+
+using namespace pat;
+
+TEST_CASE( "n Queens with a portfolio of heuristics", "[portfolio]" )
+{
+  const uint32_t n = 20;
+
+  auto first = queens_solver<solver<pick_first>>( n );
+  auto mrv = queens_solver( n );
+  auto random = queens_solver<random_solver>( n, random_mrv_heuristic( 42 ) );
+
+  const auto result = solve_portfolio( first, mrv, random );
+  CHECK( result.satisfiable );
+  CHECK( result.status == solve_status::complete );
+  CHECK( result.winner < 3u );
+  REQUIRE( result.options.size() == n );
+
+  std::set<uint64_t> rows, cols, diags, antidiags;
+  for ( auto o : result.options )
+  {
+    rows.insert( o / n );
+    cols.insert( o % n );
+    diags.insert( o / n + o % n );
+    antidiags.insert( n + o / n - o % n );
+  }
+  CHECK( rows.size() == n );
+  CHECK( cols.size() == n );
+  CHECK( diags.size() == n );
+  CHECK( antidiags.size() == n );
+
+  /* solvers can be used again */
+  CHECK( mrv.solve( stop_after_first ) == 1u );
+}
+
+TEST_CASE( "Unsatisfiable Langford pairs with a portfolio", "[portfolio]" )
+{
+  std::vector<random_solver> solvers;
+  for ( auto seed = 0u; seed < 4u; ++seed )
+  {
+    solvers.push_back( langford_solver<random_solver>( 5u, random_mrv_heuristic( seed ) ) );
+  }
+
+  const auto result = solve_portfolio( solvers );
+  CHECK( !result.satisfiable );
+  CHECK( result.status == solve_status::complete );
+  CHECK( result.winner < 4u );
+  CHECK( result.options.empty() );
+}
+
+TEST_CASE( "Portfolio without an answer", "[portfolio]" )
+{
+  std::vector<default_solver> solvers;
+  for ( auto k = 0u; k < 2u; ++k )
+  {
+    solvers.push_back( langford_solver( 11u ) );
+
+    search_limits limits;
+    limits.max_nodes = 5u;
+    solvers.back().set_limits( limits );
+  }
+
+  const auto result = solve_portfolio( solvers );
+  CHECK( !result.satisfiable );
+  CHECK( !result.decided() );
+  CHECK( result.status == solve_status::budget_exhausted );
+
+  /* limits are restored */
+  CHECK( solvers[0].current_limits().max_nodes == 5u );
+  CHECK( solvers[0].current_limits().cancel == nullptr );
+}
+
+TEST_CASE( "n Queens with a worker-local portfolio", "[portfolio]" )
+{
+  const uint32_t n = 16;
+
+  numa_statistics stats;
+  const auto result = solve_portfolio_local( 4u, [n]( std::size_t index ) {
+    return queens_solver<random_solver>( n, random_mrv_heuristic( index ) );
+  }, &stats );
+
+  CHECK( result.satisfiable );
+  CHECK( result.options.size() == n );
+
+  REQUIRE( stats.workers.size() == 4u );
+  for ( const auto& w : stats.workers )
+  {
+    CHECK( w.local_pages <= w.pages );
+  }
+
+  uint32_t workers = 0u;
+  for ( const auto& p : stats.per_node() )
+  {
+    workers += p.second.workers;
+  }
+  CHECK( workers == 4u );
+}
+
+TEST_CASE( "Parsing CPU lists of NUMA nodes", "[portfolio]" )
+{
+  using ranges = std::vector<std::pair<int, int>>;
+  CHECK( detail::parse_cpu_list( "0-3,8-11\n" ) == ranges{{0, 3}, {8, 11}} );
+  CHECK( detail::parse_cpu_list( "5" ) == ranges{{5, 5}} );
+
+  /* memory-only nodes have an empty list */
+  CHECK( detail::parse_cpu_list( "" ).empty() );
+  CHECK( detail::parse_cpu_list( "\n" ).empty() );
+  CHECK( detail::parse_cpu_list( "x,2-1,4-,7" ) == ranges{{7, 7}} );
+
+  for ( const auto& cpu : detail::interleaved_cpus() )
+  {
+    CHECK( cpu.cpu >= 0 );
+    CHECK( cpu.node >= 0 );
+  }
+}
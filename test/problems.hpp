@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <pat/pat.hpp>
+
+/* Problems that are shared by several tests */
+
+/* n Queens: rows 1, ..., n and columns n + 1, ..., 2n are primary items, the
+   2n - 1 diagonals and 2n - 1 anti-diagonals are secondary items, and option
+   (i - 1) * n + (j - 1) places a queen in row i and column j */
+inline std::vector<std::vector<uint32_t>> queens_options( uint32_t n )
+{
+  std::vector<std::vector<uint32_t>> options;
+  for ( uint32_t i = 1u; i <= n; ++i )
+  {
+    for ( uint32_t j = 1u; j <= n; ++j )
+    {
+      options.push_back( {i, n + j, 2 * n - 1 + i + j, 5 * n - 1 + i - j} );
+    }
+  }
+  return options;
+}
+
+inline pat::exact_cover_instance queens_instance( uint32_t n )
+{
+  pat::exact_cover_instance instance;
+  instance.primary_items = 2 * n;
+  instance.secondary_items = 4 * n - 2;
+  instance.options = queens_options( n );
+  return instance;
+}
+
+/* further constructor arguments, e.g., item selection and allocator, are forwarded */
+template<class Solver = pat::default_solver, class... Args>
+inline Solver queens_solver( uint32_t n, Args&&... args )
+{
+  Solver solver( 2 * n, 4 * n - 2, std::forward<Args>( args )... );
+  for ( const auto& option : queens_options( n ) )
+  {
+    solver.add_option( option );
+  }
+  return solver;
+}
+
+/* Langford pairs: positions 1, ..., 2n and pairs 2n + 1, ..., 3n are primary
+   items, and each option places pair i at positions j and i + j + 1; all items
+   are shifted by offset, e.g., to build disjoint copies */
+inline std::vector<std::vector<uint32_t>> langford_options( uint32_t n, uint32_t offset = 0u )
+{
+  std::vector<std::vector<uint32_t>> options;
+  for ( auto i = 1u; i <= n; ++i )
+  {
+    for ( auto j = 1u; j <= 2u * n - 1u - i; ++j )
+    {
+      options.push_back( {offset + 2 * n + i, offset + j, offset + i + j + 1u} );
+    }
+  }
+  return options;
+}
+
+template<class Solver = pat::default_solver, class... Args>
+inline Solver langford_solver( uint32_t n, Args&&... args )
+{
+  Solver solver( 3 * n, 0u, std::forward<Args>( args )... );
+  for ( const auto& option : langford_options( n ) )
+  {
+    solver.add_option( option );
+  }
+  return solver;
+}
@@ -1,9 +1,13 @@
 #include <catch.hpp>
 
 #include <cstdint>
+#include <utility>
+#include <vector>
 
 #include <pat/pat.hpp>
 
+#include "problems.hpp"
+
 using namespace pat;
 
 inline auto n_queens_primary( uint8_t n )
@@ -62,6 +66,45 @@ inline auto n_queens_secondary( uint8_t n )
   return solver.solve();
 }
 
+inline auto n_queens_symmetric( uint8_t n )
+{
+  auto solver = queens_solver( n );
+
+  /* rotation and reflection generate all 8 symmetries of the board */
+  const auto index = [n]( uint32_t i, uint32_t j ) { return ( i - 1 ) * n + ( j - 1 ); };
+  std::vector<uint32_t> rotation( n * n ), reflection( n * n );
+  for ( uint32_t i = 1u; i <= n; ++i )
+  {
+    for ( uint32_t j = 1u; j <= n; ++j )
+    {
+      rotation[index( i, j )] = index( j, n + 1 - i );
+      reflection[index( i, j )] = index( i, n + 1 - j );
+    }
+  }
+  solver.add_symmetry( rotation );
+  solver.add_symmetry( reflection );
+
+  const auto orbits = solver.solve();
+  return std::make_pair( orbits, solver.symmetric_solutions() );
+}
+
+template<uint32_t n>
+inline auto n_queens_static()
+{
+  constexpr uint32_t primary_items = 2 * n;
+  constexpr uint32_t secondary_items = 4 * n - 2;
+  constexpr uint32_t max_nodes = primary_items + secondary_items + 2 + n * n * 5;
+
+  static_solver<primary_items, secondary_items, max_nodes> solver;
+
+  for ( const auto& option : queens_options( n ) )
+  {
+    solver.add_option( option );
+  }
+
+  return solver.solve();
+}
+
 TEST_CASE( "n Queens (primary)", "[examples]" )
 {
   CHECK( n_queens_primary( 4 ) == 2 );
@@ -75,3 +118,44 @@ TEST_CASE( "n Queens (secondary)", "[examples]" )
   CHECK( n_queens_secondary( 8 ) == 92 );
   CHECK( n_queens_secondary( 10 ) == 724 );
 }
+
+TEST_CASE( "n Queens (symmetry breaking)", "[examples]" )
+{
+  CHECK( n_queens_symmetric( 4 ) == std::make_pair( 1u, 2u ) );
+  CHECK( n_queens_symmetric( 8 ) == std::make_pair( 12u, 92u ) );
+  CHECK( n_queens_symmetric( 10 ) == std::make_pair( 92u, 724u ) );
+}
+
+TEST_CASE( "n Queens (static)", "[examples]" )
+{
+  CHECK( n_queens_static<4>() == 2 );
+  CHECK( n_queens_static<8>() == 92 );
+  CHECK( n_queens_static<10>() == 724 );
+}
+
+template<class Solver>
+inline auto n_queens_index_width( uint32_t n )
+{
+  auto solver = queens_solver<Solver>( n );
+
+  uint32_t diagonal = 0u;
+  const auto solutions = solver.solve( [&]( auto begin, auto end ) {
+    for ( auto it = begin; it != end; ++it )
+    {
+      const auto o = solver.option_index( *it );
+      diagonal += o / n == o % n ? 1u : 0u;
+    }
+    return true;
+  } );
+  return std::make_pair( solutions, diagonal );
+}
+
+TEST_CASE( "n Queens with different index widths", "[examples]" )
+{
+  const auto expected = n_queens_index_width<default_solver>( 10 );
+  CHECK( expected.first == 724u );
+  CHECK( n_queens_index_width<compact_solver>( 10 ) == expected );
+  CHECK( n_queens_index_width<large_solver>( 10 ) == expected );
+  CHECK( sizeof( compact_solver::node_type ) == 6u );
+  CHECK( sizeof( large_solver::node_type ) == 24u );
+}
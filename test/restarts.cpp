@@ -0,0 +1,60 @@
+#include <catch.hpp>
+
+#include <cstdint>
+#include <set>
+#include <vector>
+
+#include <pat/pat.hpp>
+
+#include "problems.hpp"
+
+using namespace pat;
+
+TEST_CASE( "Luby sequence", "[restarts]" )
+{
+  const std::vector<uint64_t> expected{1, 1, 2, 1, 1, 2, 4, 1, 1, 2, 1, 1, 2, 4, 8, 1};
+  for ( auto i = 0u; i < expected.size(); ++i )
+  {
+    CHECK( detail::luby( i + 1 ) == expected[i] );
+  }
+}
+
+TEST_CASE( "n Queens with randomized restarts", "[examples]" )
+{
+  const uint32_t n = 16;
+
+  for ( auto seed = 0u; seed < 4u; ++seed )
+  {
+    auto solver = queens_solver<random_solver>( n, random_mrv_heuristic( seed ) );
+
+    std::set<uint32_t> rows, cols, diags, antidiags;
+    const auto solutions = solver.solve_with_restarts( [&]( auto begin, auto end ) {
+      for ( auto it = begin; it != end; ++it )
+      {
+        const auto o = solver.option_index( *it );
+        rows.insert( o / n );
+        cols.insert( o % n );
+        diags.insert( o / n + o % n );
+        antidiags.insert( o / n + n - o % n );
+      }
+      return false;
+    },
+                                                       64u, seed );
+
+    CHECK( solutions == 1u );
+    CHECK( rows.size() == n );
+    CHECK( cols.size() == n );
+    CHECK( diags.size() == n );
+    CHECK( antidiags.size() == n );
+  }
+}
+
+TEST_CASE( "Restarts leave the matrix intact", "[examples]" )
+{
+  auto solver = queens_solver<random_solver>( 8u );
+
+  CHECK( solver.solve_with_restarts( stop_after_first, 4u ) == 1u );
+  CHECK( solver.solve() == 92u );
+  CHECK( solver.solve_with_restarts( stop_after( 3u ), 2u ) == 3u );
+  CHECK( solver.solve() == 92u );
+}
@@ -0,0 +1,68 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <vector>
+
+#include <pat/pat.hpp>
+
+#include "problems.hpp"
+
+using namespace pat;
+
+TEST_CASE( "Uniform sampling of n Queens solutions", "[sampling]" )
+{
+  auto solver = queens_solver( 6 );
+  std::mt19937_64 rng( 1 );
+
+  std::map<std::vector<uint32_t>, uint32_t> frequency;
+  for ( auto sample : solver.sample_uniform( 4000u, rng ) )
+  {
+    std::sort( sample.begin(), sample.end() );
+    ++frequency[sample];
+  }
+
+  /* 6 Queens has 4 solutions, each should be drawn about 1000 times */
+  CHECK( frequency.size() == 4u );
+  for ( const auto& p : frequency )
+  {
+    CHECK( p.first.size() == 6u );
+    CHECK( p.second > 850u );
+    CHECK( p.second < 1150u );
+  }
+
+  CHECK( solver.solve() == 4u );
+}
+
+TEST_CASE( "Uniform sampling without solutions", "[sampling]" )
+{
+  default_solver solver( 3 );
+  solver.add_option( std::vector<uint32_t>{1, 2} );
+  solver.add_option( std::vector<uint32_t>{2, 3} );
+
+  std::mt19937_64 rng( 1 );
+  CHECK( solver.sample_uniform( 10u, rng ).empty() );
+}
+
+TEST_CASE( "Weighted probes estimate the number of solutions", "[sampling]" )
+{
+  auto solver = queens_solver( 8 );
+  std::mt19937_64 rng( 1 );
+
+  const auto probes = solver.sample_weighted( 20000u, rng );
+  auto sum = 0.0;
+  auto complete = true;
+  for ( const auto& probe : probes )
+  {
+    sum += probe.weight;
+    complete = complete && ( probe.weight == 0.0 || probe.options.size() == 8u );
+  }
+  CHECK( complete );
+
+  const auto estimate = sum / probes.size();
+  CHECK( estimate > 80.0 );
+  CHECK( estimate < 104.0 );
+  CHECK( solver.solve() == 92u );
+}
@@ -0,0 +1,152 @@
+#include <catch.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <pat/pat.hpp>
+
+#include "problems.hpp"
+
+using namespace pat;
+
+TEST_CASE( "Bounded queue with several producers and consumers", "[pipeline]" )
+{
+  detail::bounded_queue<uint64_t> queue( 8u );
+
+  uint64_t v = 0u;
+  CHECK( !queue.try_pop( v ) );
+  for ( auto k = 0u; k < 8u; ++k )
+  {
+    v = k;
+    CHECK( queue.try_push( v ) );
+  }
+  v = 8u;
+  CHECK( !queue.try_push( v ) );
+  for ( auto k = 0u; k < 8u; ++k )
+  {
+    CHECK( queue.try_pop( v ) );
+    CHECK( v == k );
+  }
+
+  const uint64_t per_producer = 5000u;
+  std::atomic<uint64_t> sum{0u}, popped{0u};
+  std::vector<std::thread> threads;
+  for ( auto p = 0u; p < 2u; ++p )
+  {
+    threads.emplace_back( [&, p]() {
+      for ( auto k = 1u; k <= per_producer; ++k )
+      {
+        uint64_t value = p * per_producer + k;
+        while ( !queue.try_push( value ) )
+        {
+          std::this_thread::yield();
+        }
+      }
+    } );
+    threads.emplace_back( [&]() {
+      uint64_t value = 0u;
+      while ( popped.load() < 2u * per_producer )
+      {
+        if ( queue.try_pop( value ) )
+        {
+          sum += value;
+          ++popped;
+        }
+        else
+        {
+          std::this_thread::yield();
+        }
+      }
+    } );
+  }
+  for ( auto& t : threads )
+  {
+    t.join();
+  }
+
+  const auto n = 2u * per_producer;
+  CHECK( sum.load() == n * ( n + 1u ) / 2u );
+}
+
+TEST_CASE( "n Queens with solutions processed by consumer threads", "[pipeline]" )
+{
+  const uint32_t n = 8;
+  auto solver = queens_solver( n );
+
+  std::mutex mutex;
+  std::set<std::set<uint64_t>> solutions;
+  auto valid = true;
+  const auto count = solve_pipelined( solver, [&]( const std::vector<uint64_t>& options ) {
+    std::set<uint64_t> rows, cols;
+    for ( auto o : options )
+    {
+      rows.insert( o / n );
+      cols.insert( o % n );
+    }
+
+    std::lock_guard<std::mutex> lock( mutex );
+    valid = valid && rows.size() == n && cols.size() == n;
+    solutions.emplace( options.begin(), options.end() );
+  }, 3u, 4u );
+
+  CHECK( count == 92u );
+  CHECK( solutions.size() == 92u );
+  CHECK( valid );
+}
+
+TEST_CASE( "Back-pressure from a slow consumer", "[pipeline]" )
+{
+  auto solver = langford_solver( 8u );
+
+  std::atomic<uint64_t> processed{0u};
+  std::atomic<bool> valid{true};
+  {
+    solution_pipeline<std::function<void( const std::vector<uint64_t>& )>> pipeline( [&]( const std::vector<uint64_t>& options ) {
+      valid = valid && options.size() == 8u;
+      std::this_thread::sleep_for( std::chrono::microseconds( 50 ) );
+      ++processed;
+    }, 1u, 2u );
+
+    CHECK( solver.solve( pipeline.callback( solver ) ) == 300u );
+    CHECK( pipeline.stalls() != 0u );
+  }
+  CHECK( processed.load() == 300u );
+  CHECK( valid.load() );
+}
+
+TEST_CASE( "Several search threads share a pipeline", "[pipeline]" )
+{
+  std::atomic<uint64_t> processed{0u};
+  std::atomic<bool> valid{true};
+  {
+    solution_pipeline<std::function<void( const std::vector<uint64_t>& )>> pipeline( [&]( const std::vector<uint64_t>& options ) {
+      std::set<uint64_t> rows, cols;
+      for ( auto o : options )
+      {
+        rows.insert( o / 8u );
+        cols.insert( o % 8u );
+      }
+      valid = valid && options.size() == 8u && rows.size() == 8u && cols.size() == 8u;
+      ++processed;
+    }, 2u, 4u );
+
+    std::vector<std::thread> searches;
+    for ( auto t = 0u; t < 2u; ++t )
+    {
+      searches.emplace_back( [&]() {
+        auto solver = queens_solver( 8u );
+        solver.solve( pipeline.callback( solver ) );
+      } );
+    }
+    for ( auto& t : searches )
+    {
+      t.join();
+    }
+  }
+  CHECK( processed.load() == 184u );
+  CHECK( valid.load() );
+}
@@ -0,0 +1,124 @@
+#include <catch.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include <pat/pat.hpp>
+
+#include "problems.hpp"
+
+using namespace pat;
+
+TEST_CASE( "Resumable search in slices of nodes", "[stepping]" )
+{
+  auto solver = langford_solver( 11u );
+  CHECK( solver.solve() == 35584u );
+  const auto nodes = solver.nodes_visited();
+
+  uint64_t solutions = 0u, slices = 0u;
+  do
+  {
+    solutions += solver.solve_steps( 10000u );
+    ++slices;
+    CHECK( solver.nodes_visited() <= 10000u * slices );
+  } while ( solver.is_paused() );
+
+  CHECK( solver.status() == solve_status::complete );
+  CHECK( solutions == 35584u );
+  CHECK( slices == ( nodes + 9999u ) / 10000u );
+  CHECK( solver.nodes_visited() == nodes );
+}
+
+TEST_CASE( "Resumable search in slices of time", "[stepping]" )
+{
+  auto solver = langford_solver( 11u );
+
+  search_limits limits;
+  limits.check_interval = 64u;
+  solver.set_limits( limits );
+
+  uint64_t solutions = 0u;
+  do
+  {
+    solutions += solver.solve_steps( std::numeric_limits<uint64_t>::max(), std::chrono::microseconds( 200 ) );
+  } while ( solver.is_paused() );
+
+  CHECK( solutions == 35584u );
+}
+
+TEST_CASE( "Stopping and aborting a resumable search", "[stepping]" )
+{
+  auto solver = langford_solver( 11u );
+
+  /* the callback stops the search */
+  uint32_t found = 0u;
+  while ( solver.solve_steps( 100u, std::chrono::steady_clock::duration::max(), [&]( auto, auto ) { return ++found < 5u; } ) == 0u && solver.is_paused() )
+  {
+  }
+  CHECK( solver.status() == solve_status::stopped );
+  CHECK( !solver.is_paused() );
+
+  /* a paused search is aborted explicitly or by another search */
+  solver.solve_steps( 1000u );
+  CHECK( solver.is_paused() );
+  solver.abort_steps();
+  CHECK( !solver.is_paused() );
+  CHECK( solver.solve() == 35584u );
+
+  solver.solve_steps( 1000u );
+  CHECK( solver.is_paused() );
+  CHECK( solver.solve_decomposed() == 35584u );
+  CHECK( solver.solve() == 35584u );
+
+  /* resetting the matrix aborts a paused search */
+  solver.solve_steps( 100u );
+  CHECK( solver.is_paused() );
+  solver.reset( 3u );
+  CHECK( !solver.is_paused() );
+  solver.add_option( std::vector<uint32_t>{1u, 2u} );
+  solver.add_option( std::vector<uint32_t>{3u} );
+  CHECK( solver.solve() == 1u );
+}
+
+TEST_CASE( "Changing the search setup aborts a resumable search", "[stepping]" )
+{
+  auto solver = langford_solver( 9u );
+
+  solver.solve_steps( 100u );
+  CHECK( solver.is_paused() );
+  solver.enable_failure_cache( 1024u );
+  CHECK( !solver.is_paused() );
+  CHECK( solver.solve_steps( 1000000000u ) == 0u );
+  CHECK( solver.status() == solve_status::complete );
+
+  auto symmetric = langford_solver( 4u );
+  CHECK( symmetric.solve_steps( 1u ) == 0u );
+  CHECK( symmetric.is_paused() );
+  std::vector<uint32_t> reversal( 13u );
+  for ( auto j = 1u; j <= 12u; ++j )
+  {
+    reversal[j] = j <= 8u ? 9u - j : j;
+  }
+  symmetric.add_item_symmetry( reversal );
+  CHECK( !symmetric.is_paused() );
+  CHECK( symmetric.solve() == 1u );
+  CHECK( symmetric.symmetric_solutions() == 2u );
+}
+
+#if defined( PAT_HAS_COROUTINES )
+TEST_CASE( "Resumable search as a coroutine", "[stepping]" )
+{
+  auto solver = langford_solver( 11u );
+
+  auto task = solve_stepwise( solver, 1000u );
+  auto slices = 0u;
+  while ( task.resume() )
+  {
+    ++slices;
+  }
+  CHECK( slices > 1u );
+  CHECK( task.done() );
+  CHECK( task.solutions() == 35584u );
+}
+#endif
@@ -0,0 +1,84 @@
+#include <catch.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <pat/pat.hpp>
+
+using namespace pat;
+
+/* option 81 * r + 9 * c + d places digit d + 1 in row r and column c */
+inline void add_sudoku_options( default_solver& solver )
+{
+  for ( auto r = 0u; r < 9u; ++r )
+  {
+    for ( auto c = 0u; c < 9u; ++c )
+    {
+      const auto b = 3u * ( r / 3u ) + c / 3u;
+      for ( auto d = 0u; d < 9u; ++d )
+      {
+        solver.add_option( std::vector<uint32_t>{1u + 9u * r + c, 82u + 9u * r + d, 163u + 9u * c + d, 244u + 9u * b + d} );
+      }
+    }
+  }
+}
+
+inline std::vector<uint32_t> givens( const std::string& puzzle )
+{
+  std::vector<uint32_t> options;
+  for ( auto k = 0u; k < 81u; ++k )
+  {
+    if ( puzzle[k] != '.' )
+    {
+      options.push_back( 9u * k + ( puzzle[k] - '1' ) );
+    }
+  }
+  return options;
+}
+
+inline std::string to_string( const std::vector<uint32_t>& solution )
+{
+  std::string grid( 81u, '.' );
+  for ( auto o : solution )
+  {
+    grid[o / 9u] = static_cast<char>( '1' + o % 9u );
+  }
+  return grid;
+}
+
+TEST_CASE( "Sudoku puzzles on a prebuilt matrix", "[sudoku]" )
+{
+  default_solver solver( 324u );
+  add_sudoku_options( solver );
+
+  const std::string puzzle = "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79";
+  const std::string solution = "534678912672195348198342567859761423426853791713924856961537284287419635345286179";
+
+  std::vector<uint32_t> found;
+  CHECK( solver.check_uniqueness( givens( puzzle ), &found ) == uniqueness::unique );
+  CHECK( to_string( found ) == solution );
+
+  /* removing givens makes the solution ambiguous */
+  auto ambiguous = puzzle;
+  for ( auto k = 0u; k < 40u; ++k )
+  {
+    ambiguous[k] = '.';
+  }
+  CHECK( solver.check_uniqueness( givens( ambiguous ) ) == uniqueness::multiple );
+
+  /* two fives in the first row */
+  auto contradictory = puzzle;
+  contradictory[2] = '5';
+  CHECK( solver.check_uniqueness( givens( contradictory ) ) == uniqueness::none );
+
+  /* a consistent, but unsolvable grid */
+  auto unsolvable = puzzle;
+  unsolvable[2] = '2';
+  CHECK( solver.check_uniqueness( givens( unsolvable ) ) == uniqueness::none );
+  CHECK( solver.nodes_visited() != 0u );
+
+  /* the matrix is restored after each puzzle */
+  CHECK( solver.check_uniqueness( givens( puzzle ) ) == uniqueness::unique );
+  CHECK( solver.solve_given( givens( std::string( 81u, '.' ) ), stop_after( 5u ) ) == 5u );
+}
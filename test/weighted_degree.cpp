@@ -0,0 +1,33 @@
+#include <catch.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include <pat/pat.hpp>
+
+#include "problems.hpp"
+
+using namespace pat;
+
+TEST_CASE( "Langford pairs with weighted degree heuristic", "[examples]" )
+{
+  auto solver = langford_solver<wdeg_solver>( 8 );
+  CHECK( solver.solve() == 300u );
+
+  /* dead ends have been reported to the heuristic */
+  auto learned = false;
+  for ( auto i = 1u; i <= 24u; ++i )
+  {
+    learned = learned || solver.selection().weight( i ) > 1.0;
+  }
+  CHECK( learned );
+
+  CHECK( langford_solver<wdeg_solver>( 5 ).solve() == 0u );
+  CHECK( langford_solver<wdeg_solver>( 11 ).solve() == 35584u );
+}
+
+TEST_CASE( "n Queens with weighted degree heuristic", "[examples]" )
+{
+  auto solver = queens_solver<wdeg_solver>( 10u );
+  CHECK( solver.solve() == 724u );
+}